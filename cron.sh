@@ -1,10 +1,7 @@
 #! /bin/sh
 
+# One run of the default probes (one core and one socket of node 0, and the whole machine) per invocation:
+# the results are appended to bandwidth-history.csv and compared with the baseline of the host.
+# Without cron, "./bandwidth -Q default -U 3600" keeps running and measures them every hour.
 
-MONOCORE_LOG=1c.log
-MONOSOCKET_LOG=1s.log
-FULL_LOG=2s.log
-
-{ echo -n "[$(date)] " ; numactl -N 0 -m 0 -C 0 ./bandwidth -s 1GiB -c 1 | head -2 | tail -1 ; } >> $MONOCORE_LOG
-{ echo -n "[$(date)] " ; numactl -N 0 -m 0 ./bandwidth -s 4GiB -c 1 | head -2 | tail -1 ; } >> $MONOSOCKET_LOG
-{ echo -n "[$(date)] " ; ./bandwidth -s 8GiB -c 1 | head -2 | tail -1 ; } >> $FULL_LOG
+./bandwidth -Q default -U 0 -Y bandwidth-history.csv -c 1 -u exit
@@ -1,6 +1,28 @@
 #ifndef ALLOCATION_H
 #define ALLOCATION_H
 
+#include <vector>
+
+// NUMA placement of the buffers returned by allocate()
+enum class mem_policy { local, bind, interleave };
+// an empty node list means every node
+void set_mem_policy(mem_policy policy, const std::vector<int>& nodes = {});
+mem_policy get_mem_policy();
+std::vector<int> get_mem_nodes();
+const char* mem_policy_name(mem_policy policy);
+
+// page size of the buffers returned by allocate() (system: no request, transparent huge pages as configured
+// in /sys/kernel/mm/transparent_hugepage)
+enum class page_policy { system, small, thp, huge_2m, huge_1g };
+void set_page_policy(page_policy policy);
+page_policy get_page_policy();
+const char* page_policy_name(page_policy policy);
+// parses "system", "4k", "thp", "2m" or "1g" (returns false if not recognized)
+bool parse_page_policy(const char* s, page_policy& policy);
+
+// receives the warnings and errors of allocate() (nothing is reported until it is set)
+void set_allocation_log(void (*log)(const char* message));
+
 void* allocate(unsigned long long int n, unsigned long long int alignment = 1);
 void deallocate(void* ptr);
 
@@ -7,11 +7,15 @@
 #include "types.h"
 
 
+// software prefetch hints (the locality argument of __builtin_prefetch)
+enum prefetch_hint { prefetch_nta = 0, prefetch_t2 = 1, prefetch_t1 = 2, prefetch_t0 = 3 };
+
 struct bandwidth {
   // kernel size
   int kern = 0;
   bool nontemporal = false;
-  // versions
+  // versions (mix: reads k arrays A, A+s, ... and writes their sum to w arrays B, B+s, ...,
+  // A is not accessed if k = 0 nor B if w = 0: they may be null)
 #ifdef F16_MEM_OPS
   float64_t (*read_f16 )(const float16_t *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*write_f16)(      float16_t *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
@@ -21,6 +25,7 @@ struct bandwidth {
   float64_t (*scale_f16)(const float16_t *restrict A,       float16_t *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*add_f16  )(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*triad_f16)(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*mix_f16)(const float16_t *restrict A, float16_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) noexcept = nullptr;
 #endif /* F16_ARI_OPS */
 #endif /* F16_MEM_OPS */
   float64_t (*read_f32 )(const float32_t *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
@@ -30,6 +35,7 @@ struct bandwidth {
   float64_t (*scale_f32)(const float32_t *restrict A,       float32_t *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*add_f32  )(const float32_t *restrict A, const float32_t *restrict B, float32_t *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*triad_f32)(const float32_t *restrict A, const float32_t *restrict B, float32_t *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*mix_f32)(const float32_t *restrict A, float32_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) noexcept = nullptr;
   float64_t (*read_f64 )(const float64_t *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*write_f64)(      float64_t *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*copy_f64 )(const float64_t *restrict A,       float64_t *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
@@ -37,6 +43,45 @@ struct bandwidth {
   float64_t (*scale_f64)(const float64_t *restrict A,       float64_t *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*add_f64  )(const float64_t *restrict A, const float64_t *restrict B, float64_t *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
   float64_t (*triad_f64)(const float64_t *restrict A, const float64_t *restrict B, float64_t *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*mix_f64)(const float64_t *restrict A, float64_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_i8 )(const int8_t   *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_i8)(      int8_t   *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_i8 )(const int8_t   *restrict A,       int8_t   *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_i8 )(      int8_t   *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_i8)(const int8_t   *restrict A,       int8_t   *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_i8  )(const int8_t   *restrict A, const int8_t   *restrict B, int8_t   *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_i8)(const int8_t   *restrict A, const int8_t   *restrict B, int8_t   *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*mix_i8)(const int8_t *restrict A, int8_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_i16 )(const int16_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_i16)(      int16_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_i16 )(const int16_t  *restrict A,       int16_t  *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_i16 )(      int16_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_i16)(const int16_t  *restrict A,       int16_t  *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_i16  )(const int16_t  *restrict A, const int16_t  *restrict B, int16_t  *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_i16)(const int16_t  *restrict A, const int16_t  *restrict B, int16_t  *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*mix_i16)(const int16_t *restrict A, int16_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_i32 )(const int32_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_i32)(      int32_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_i32 )(const int32_t  *restrict A,       int32_t  *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_i32 )(      int32_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_i32)(const int32_t  *restrict A,       int32_t  *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_i32  )(const int32_t  *restrict A, const int32_t  *restrict B, int32_t  *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_i32)(const int32_t  *restrict A, const int32_t  *restrict B, int32_t  *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*mix_i32)(const int32_t *restrict A, int32_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_i64 )(const int64_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_i64)(      int64_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_i64 )(const int64_t  *restrict A,       int64_t  *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_i64 )(      int64_t  *restrict A,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_i64)(const int64_t  *restrict A,       int64_t  *restrict B,                        long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_i64  )(const int64_t  *restrict A, const int64_t  *restrict B, int64_t  *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_i64)(const int64_t  *restrict A, const int64_t  *restrict B, int64_t  *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*mix_i64)(const int64_t *restrict A, int64_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) noexcept = nullptr;
+  // one untimed pass over f64 arrays, without synchronizing with the other threads
+  // (the background traffic of loaded.h)
+  void (*pass_read )(const float64_t *restrict A,                                                     long long n) noexcept = nullptr;
+  void (*pass_write)(      float64_t *restrict A,                                                     long long n) noexcept = nullptr;
+  void (*pass_copy )(const float64_t *restrict A,       float64_t *restrict B,                        long long n) noexcept = nullptr;
+  void (*pass_triad)(const float64_t *restrict A, const float64_t *restrict B, float64_t *restrict C, long long n) noexcept = nullptr;
 
   // overloads
 #ifdef F16_MEM_OPS
@@ -62,6 +107,9 @@ struct bandwidth {
   float64_t triad(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, int repeat, int tries) const noexcept {
     return triad_f16(A, B, C, n, repeat, tries);
   }
+  float64_t mix(const float16_t *restrict A, float16_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) const noexcept {
+    return mix_f16(A, B, n, s, k, w, repeat, tries);
+  }
 #else /* F16_ARI_OPS */
   float64_t incr(float16_t *restrict A, long long n, int repeat, int tries) const noexcept {
     return 0.;
@@ -75,6 +123,9 @@ struct bandwidth {
   float64_t triad(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, int repeat, int tries) const noexcept {
     return 0.;
   }
+  float64_t mix(const float16_t *restrict A, float16_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) const noexcept {
+    return 0.;
+  }
 #endif /* F16_ARI_OPS */
 #endif /* F16_MEM_OPS */
   float64_t read(const float32_t *restrict A, long long n, int repeat, int tries) const noexcept {
@@ -98,6 +149,9 @@ struct bandwidth {
   float64_t triad(const float32_t *restrict A, const float32_t *restrict B, float32_t *restrict C, long long n, int repeat, int tries) const noexcept {
     return triad_f32(A, B, C, n, repeat, tries);
   }
+  float64_t mix(const float32_t *restrict A, float32_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) const noexcept {
+    return mix_f32(A, B, n, s, k, w, repeat, tries);
+  }
   float64_t read(const float64_t *restrict A, long long n, int repeat, int tries) const noexcept {
     return read_f64(A, n, repeat, tries);
   }
@@ -119,9 +173,415 @@ struct bandwidth {
   float64_t triad(const float64_t *restrict A, const float64_t *restrict B, float64_t*restrict C, long long n, int repeat, int tries) const noexcept {
     return triad_f64(A, B, C, n, repeat, tries);
   }
+  float64_t mix(const float64_t *restrict A, float64_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) const noexcept {
+    return mix_f64(A, B, n, s, k, w, repeat, tries);
+  }
+  float64_t read(const int8_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return read_i8(A, n, repeat, tries);
+  }
+  float64_t write(int8_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return write_i8(A, n, repeat, tries);
+  }
+  float64_t copy(const int8_t *restrict A, int8_t *restrict B, long long n, int repeat, int tries) const noexcept {
+    return copy_i8(A, B, n, repeat, tries);
+  }
+  float64_t incr(int8_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return incr_i8(A, n, repeat, tries);
+  }
+  float64_t scale(const int8_t *restrict A, int8_t *restrict B, long long n, int repeat, int tries) const noexcept {
+    return scale_i8(A, B, n, repeat, tries);
+  }
+  float64_t add(const int8_t *restrict A, const int8_t *restrict B, int8_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return add_i8(A, B, C, n, repeat, tries);
+  }
+  float64_t triad(const int8_t *restrict A, const int8_t *restrict B, int8_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return triad_i8(A, B, C, n, repeat, tries);
+  }
+  float64_t mix(const int8_t *restrict A, int8_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) const noexcept {
+    return mix_i8(A, B, n, s, k, w, repeat, tries);
+  }
+  float64_t read(const int16_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return read_i16(A, n, repeat, tries);
+  }
+  float64_t write(int16_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return write_i16(A, n, repeat, tries);
+  }
+  float64_t copy(const int16_t *restrict A, int16_t *restrict B, long long n, int repeat, int tries) const noexcept {
+    return copy_i16(A, B, n, repeat, tries);
+  }
+  float64_t incr(int16_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return incr_i16(A, n, repeat, tries);
+  }
+  float64_t scale(const int16_t *restrict A, int16_t *restrict B, long long n, int repeat, int tries) const noexcept {
+    return scale_i16(A, B, n, repeat, tries);
+  }
+  float64_t add(const int16_t *restrict A, const int16_t *restrict B, int16_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return add_i16(A, B, C, n, repeat, tries);
+  }
+  float64_t triad(const int16_t *restrict A, const int16_t *restrict B, int16_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return triad_i16(A, B, C, n, repeat, tries);
+  }
+  float64_t mix(const int16_t *restrict A, int16_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) const noexcept {
+    return mix_i16(A, B, n, s, k, w, repeat, tries);
+  }
+  float64_t read(const int32_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return read_i32(A, n, repeat, tries);
+  }
+  float64_t write(int32_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return write_i32(A, n, repeat, tries);
+  }
+  float64_t copy(const int32_t *restrict A, int32_t *restrict B, long long n, int repeat, int tries) const noexcept {
+    return copy_i32(A, B, n, repeat, tries);
+  }
+  float64_t incr(int32_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return incr_i32(A, n, repeat, tries);
+  }
+  float64_t scale(const int32_t *restrict A, int32_t *restrict B, long long n, int repeat, int tries) const noexcept {
+    return scale_i32(A, B, n, repeat, tries);
+  }
+  float64_t add(const int32_t *restrict A, const int32_t *restrict B, int32_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return add_i32(A, B, C, n, repeat, tries);
+  }
+  float64_t triad(const int32_t *restrict A, const int32_t *restrict B, int32_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return triad_i32(A, B, C, n, repeat, tries);
+  }
+  float64_t mix(const int32_t *restrict A, int32_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) const noexcept {
+    return mix_i32(A, B, n, s, k, w, repeat, tries);
+  }
+  float64_t read(const int64_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return read_i64(A, n, repeat, tries);
+  }
+  float64_t write(int64_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return write_i64(A, n, repeat, tries);
+  }
+  float64_t copy(const int64_t *restrict A, int64_t *restrict B, long long n, int repeat, int tries) const noexcept {
+    return copy_i64(A, B, n, repeat, tries);
+  }
+  float64_t incr(int64_t *restrict A, long long n, int repeat, int tries) const noexcept {
+    return incr_i64(A, n, repeat, tries);
+  }
+  float64_t scale(const int64_t *restrict A, int64_t *restrict B, long long n, int repeat, int tries) const noexcept {
+    return scale_i64(A, B, n, repeat, tries);
+  }
+  float64_t add(const int64_t *restrict A, const int64_t *restrict B, int64_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return add_i64(A, B, C, n, repeat, tries);
+  }
+  float64_t triad(const int64_t *restrict A, const int64_t *restrict B, int64_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return triad_i64(A, B, C, n, repeat, tries);
+  }
+  float64_t mix(const int64_t *restrict A, int64_t *restrict B, long long n, long long s, int k, int w, int repeat, int tries) const noexcept {
+    return mix_i64(A, B, n, s, k, w, repeat, tries);
+  }
+};
+
+// stream kernels (temporal stores) issuing software prefetches "d" elements ahead of the accesses
+struct prefetch_bandwidth {
+  // kernel size
+  int kern = 0;
+  // software prefetch hint (prefetch_hint)
+  int hint = 0;
+  // versions
+#ifdef F16_MEM_OPS
+  float64_t (*read_f16 )(const float16_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_f16)(      float16_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_f16 )(const float16_t *restrict A,       float16_t *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+#ifdef F16_ARI_OPS
+  float64_t (*incr_f16 )(      float16_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_f16)(const float16_t *restrict A,       float16_t *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_f16  )(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_f16)(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+#endif /* F16_ARI_OPS */
+#endif /* F16_MEM_OPS */
+  float64_t (*read_f32 )(const float32_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_f32)(      float32_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_f32 )(const float32_t *restrict A,       float32_t *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_f32 )(      float32_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_f32)(const float32_t *restrict A,       float32_t *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_f32  )(const float32_t *restrict A, const float32_t *restrict B, float32_t *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_f32)(const float32_t *restrict A, const float32_t *restrict B, float32_t *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_f64 )(const float64_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_f64)(      float64_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_f64 )(const float64_t *restrict A,       float64_t *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_f64 )(      float64_t *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_f64)(const float64_t *restrict A,       float64_t *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_f64  )(const float64_t *restrict A, const float64_t *restrict B, float64_t *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_f64)(const float64_t *restrict A, const float64_t *restrict B, float64_t *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_i8 )(const int8_t    *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_i8)(      int8_t    *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_i8 )(const int8_t    *restrict A,       int8_t    *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_i8 )(      int8_t    *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_i8)(const int8_t    *restrict A,       int8_t    *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_i8  )(const int8_t    *restrict A, const int8_t    *restrict B, int8_t    *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_i8)(const int8_t    *restrict A, const int8_t    *restrict B, int8_t    *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_i16 )(const int16_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_i16)(      int16_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_i16 )(const int16_t   *restrict A,       int16_t   *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_i16 )(      int16_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_i16)(const int16_t   *restrict A,       int16_t   *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_i16  )(const int16_t   *restrict A, const int16_t   *restrict B, int16_t   *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_i16)(const int16_t   *restrict A, const int16_t   *restrict B, int16_t   *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_i32 )(const int32_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_i32)(      int32_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_i32 )(const int32_t   *restrict A,       int32_t   *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_i32 )(      int32_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_i32)(const int32_t   *restrict A,       int32_t   *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_i32  )(const int32_t   *restrict A, const int32_t   *restrict B, int32_t   *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_i32)(const int32_t   *restrict A, const int32_t   *restrict B, int32_t   *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*read_i64 )(const int64_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*write_i64)(      int64_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*copy_i64 )(const int64_t   *restrict A,       int64_t   *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*incr_i64 )(      int64_t   *restrict A,                                                      long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scale_i64)(const int64_t   *restrict A,       int64_t   *restrict B,                         long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*add_i64  )(const int64_t   *restrict A, const int64_t   *restrict B, int64_t   *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+  float64_t (*triad_i64)(const int64_t   *restrict A, const int64_t   *restrict B, int64_t   *restrict C, long long n, long long d, int repeat, int tries) noexcept = nullptr;
+
+  // overloads
+#ifdef F16_MEM_OPS
+  float64_t read(const float16_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return read_f16(A, n, d, repeat, tries);
+  }
+  float64_t write(float16_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return write_f16(A, n, d, repeat, tries);
+  }
+  float64_t copy(const float16_t *restrict A, float16_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return copy_f16(A, B, n, d, repeat, tries);
+  }
+#ifdef F16_ARI_OPS
+  float64_t incr(float16_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return incr_f16(A, n, d, repeat, tries);
+  }
+  float64_t scale(const float16_t *restrict A, float16_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return scale_f16(A, B, n, d, repeat, tries);
+  }
+  float64_t add(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return add_f16(A, B, C, n, d, repeat, tries);
+  }
+  float64_t triad(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return triad_f16(A, B, C, n, d, repeat, tries);
+  }
+#else /* F16_ARI_OPS */
+  float64_t incr(float16_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return 0.;
+  }
+  float64_t scale(const float16_t *restrict A, float16_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return 0.;
+  }
+  float64_t add(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return 0.;
+  }
+  float64_t triad(const float16_t *restrict A, const float16_t *restrict B, float16_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return 0.;
+  }
+#endif /* F16_ARI_OPS */
+#endif /* F16_MEM_OPS */
+  float64_t read(const float32_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return read_f32(A, n, d, repeat, tries);
+  }
+  float64_t write(float32_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return write_f32(A, n, d, repeat, tries);
+  }
+  float64_t copy(const float32_t *restrict A, float32_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return copy_f32(A, B, n, d, repeat, tries);
+  }
+  float64_t incr(float32_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return incr_f32(A, n, d, repeat, tries);
+  }
+  float64_t scale(const float32_t *restrict A, float32_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return scale_f32(A, B, n, d, repeat, tries);
+  }
+  float64_t add(const float32_t *restrict A, const float32_t *restrict B, float32_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return add_f32(A, B, C, n, d, repeat, tries);
+  }
+  float64_t triad(const float32_t *restrict A, const float32_t *restrict B, float32_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return triad_f32(A, B, C, n, d, repeat, tries);
+  }
+  float64_t read(const float64_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return read_f64(A, n, d, repeat, tries);
+  }
+  float64_t write(float64_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return write_f64(A, n, d, repeat, tries);
+  }
+  float64_t copy(const float64_t *restrict A, float64_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return copy_f64(A, B, n, d, repeat, tries);
+  }
+  float64_t incr(float64_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return incr_f64(A, n, d, repeat, tries);
+  }
+  float64_t scale(const float64_t *restrict A, float64_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return scale_f64(A, B, n, d, repeat, tries);
+  }
+  float64_t add(const float64_t *restrict A, const float64_t *restrict B, float64_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return add_f64(A, B, C, n, d, repeat, tries);
+  }
+  float64_t triad(const float64_t *restrict A, const float64_t *restrict B, float64_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return triad_f64(A, B, C, n, d, repeat, tries);
+  }
+  float64_t read(const int8_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return read_i8(A, n, d, repeat, tries);
+  }
+  float64_t write(int8_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return write_i8(A, n, d, repeat, tries);
+  }
+  float64_t copy(const int8_t *restrict A, int8_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return copy_i8(A, B, n, d, repeat, tries);
+  }
+  float64_t incr(int8_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return incr_i8(A, n, d, repeat, tries);
+  }
+  float64_t scale(const int8_t *restrict A, int8_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return scale_i8(A, B, n, d, repeat, tries);
+  }
+  float64_t add(const int8_t *restrict A, const int8_t *restrict B, int8_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return add_i8(A, B, C, n, d, repeat, tries);
+  }
+  float64_t triad(const int8_t *restrict A, const int8_t *restrict B, int8_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return triad_i8(A, B, C, n, d, repeat, tries);
+  }
+  float64_t read(const int16_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return read_i16(A, n, d, repeat, tries);
+  }
+  float64_t write(int16_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return write_i16(A, n, d, repeat, tries);
+  }
+  float64_t copy(const int16_t *restrict A, int16_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return copy_i16(A, B, n, d, repeat, tries);
+  }
+  float64_t incr(int16_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return incr_i16(A, n, d, repeat, tries);
+  }
+  float64_t scale(const int16_t *restrict A, int16_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return scale_i16(A, B, n, d, repeat, tries);
+  }
+  float64_t add(const int16_t *restrict A, const int16_t *restrict B, int16_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return add_i16(A, B, C, n, d, repeat, tries);
+  }
+  float64_t triad(const int16_t *restrict A, const int16_t *restrict B, int16_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return triad_i16(A, B, C, n, d, repeat, tries);
+  }
+  float64_t read(const int32_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return read_i32(A, n, d, repeat, tries);
+  }
+  float64_t write(int32_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return write_i32(A, n, d, repeat, tries);
+  }
+  float64_t copy(const int32_t *restrict A, int32_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return copy_i32(A, B, n, d, repeat, tries);
+  }
+  float64_t incr(int32_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return incr_i32(A, n, d, repeat, tries);
+  }
+  float64_t scale(const int32_t *restrict A, int32_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return scale_i32(A, B, n, d, repeat, tries);
+  }
+  float64_t add(const int32_t *restrict A, const int32_t *restrict B, int32_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return add_i32(A, B, C, n, d, repeat, tries);
+  }
+  float64_t triad(const int32_t *restrict A, const int32_t *restrict B, int32_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return triad_i32(A, B, C, n, d, repeat, tries);
+  }
+  float64_t read(const int64_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return read_i64(A, n, d, repeat, tries);
+  }
+  float64_t write(int64_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return write_i64(A, n, d, repeat, tries);
+  }
+  float64_t copy(const int64_t *restrict A, int64_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return copy_i64(A, B, n, d, repeat, tries);
+  }
+  float64_t incr(int64_t *restrict A, long long n, long long d, int repeat, int tries) const noexcept {
+    return incr_i64(A, n, d, repeat, tries);
+  }
+  float64_t scale(const int64_t *restrict A, int64_t *restrict B, long long n, long long d, int repeat, int tries) const noexcept {
+    return scale_i64(A, B, n, d, repeat, tries);
+  }
+  float64_t add(const int64_t *restrict A, const int64_t *restrict B, int64_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return add_i64(A, B, C, n, d, repeat, tries);
+  }
+  float64_t triad(const int64_t *restrict A, const int64_t *restrict B, int64_t *restrict C, long long n, long long d, int repeat, int tries) const noexcept {
+    return triad_i64(A, B, C, n, d, repeat, tries);
+  }
 };
 
-extern bandwidth bandwidth_benches[];
+// indexed accesses through an array of 32-bit indexes "idx" (32 and 64-bit elements only):
+// gather x = A[idx[i]], scatter A[idx[i]] = x and gather_add C[i] = A[idx[i]] + B[i]
+struct gather_bandwidth {
+  // kernel size
+  int kern = 0;
+  // versions
+  float64_t (*gather_f32    )(const float32_t *restrict A, const int32_t *restrict idx,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scatter_f32   )(      float32_t *restrict A, const int32_t *restrict idx,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*gather_add_f32)(const float32_t *restrict A, const int32_t *restrict idx, const float32_t *restrict B, float32_t *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*gather_f64    )(const float64_t *restrict A, const int32_t *restrict idx,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scatter_f64   )(      float64_t *restrict A, const int32_t *restrict idx,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*gather_add_f64)(const float64_t *restrict A, const int32_t *restrict idx, const float64_t *restrict B, float64_t *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*gather_i32    )(const int32_t   *restrict A, const int32_t *restrict idx,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scatter_i32   )(      int32_t   *restrict A, const int32_t *restrict idx,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*gather_add_i32)(const int32_t   *restrict A, const int32_t *restrict idx, const int32_t   *restrict B, int32_t   *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*gather_i64    )(const int64_t   *restrict A, const int32_t *restrict idx,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*scatter_i64   )(      int64_t   *restrict A, const int32_t *restrict idx,                                                     long long n, int repeat, int tries) noexcept = nullptr;
+  float64_t (*gather_add_i64)(const int64_t   *restrict A, const int32_t *restrict idx, const int64_t   *restrict B, int64_t   *restrict C, long long n, int repeat, int tries) noexcept = nullptr;
+
+  // overloads
+  float64_t gather(const float32_t *restrict A, const int32_t *restrict idx, long long n, int repeat, int tries) const noexcept {
+    return gather_f32(A, idx, n, repeat, tries);
+  }
+  float64_t scatter(float32_t *restrict A, const int32_t *restrict idx, long long n, int repeat, int tries) const noexcept {
+    return scatter_f32(A, idx, n, repeat, tries);
+  }
+  float64_t gather_add(const float32_t *restrict A, const int32_t *restrict idx, const float32_t *restrict B, float32_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return gather_add_f32(A, idx, B, C, n, repeat, tries);
+  }
+  float64_t gather(const float64_t *restrict A, const int32_t *restrict idx, long long n, int repeat, int tries) const noexcept {
+    return gather_f64(A, idx, n, repeat, tries);
+  }
+  float64_t scatter(float64_t *restrict A, const int32_t *restrict idx, long long n, int repeat, int tries) const noexcept {
+    return scatter_f64(A, idx, n, repeat, tries);
+  }
+  float64_t gather_add(const float64_t *restrict A, const int32_t *restrict idx, const float64_t *restrict B, float64_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return gather_add_f64(A, idx, B, C, n, repeat, tries);
+  }
+  float64_t gather(const int32_t *restrict A, const int32_t *restrict idx, long long n, int repeat, int tries) const noexcept {
+    return gather_i32(A, idx, n, repeat, tries);
+  }
+  float64_t scatter(int32_t *restrict A, const int32_t *restrict idx, long long n, int repeat, int tries) const noexcept {
+    return scatter_i32(A, idx, n, repeat, tries);
+  }
+  float64_t gather_add(const int32_t *restrict A, const int32_t *restrict idx, const int32_t *restrict B, int32_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return gather_add_i32(A, idx, B, C, n, repeat, tries);
+  }
+  float64_t gather(const int64_t *restrict A, const int32_t *restrict idx, long long n, int repeat, int tries) const noexcept {
+    return gather_i64(A, idx, n, repeat, tries);
+  }
+  float64_t scatter(int64_t *restrict A, const int32_t *restrict idx, long long n, int repeat, int tries) const noexcept {
+    return scatter_i64(A, idx, n, repeat, tries);
+  }
+  float64_t gather_add(const int64_t *restrict A, const int32_t *restrict idx, const int64_t *restrict B, int64_t *restrict C, long long n, int repeat, int tries) const noexcept {
+    return gather_add_i64(A, idx, B, C, n, repeat, tries);
+  }
+};
+
+// kernels compiled for one instruction set
+struct bandwidth_isa {
+  const char* name;
+  int width;        // SIMD register width in bits
+  int registers;    // number of SIMD registers
+  bool nontemporal; // non-temporal stores available
+  bandwidth* benches;
+  prefetch_bandwidth* prefetches;
+  gather_bandwidth* gathers;
+};
+
+// kernels of the selected instruction set (terminated by kern == 0)
+extern bandwidth* bandwidth_benches;
+extern prefetch_bandwidth* prefetch_benches;
+extern gather_bandwidth* gather_benches;
+extern const bandwidth_isa* current_isa;
+
+// instruction sets compiled in (terminated by nullptr), best first
+extern const bandwidth_isa* const bandwidth_isas[];
+bool isa_supported(const bandwidth_isa* isa) noexcept;
+// selects the kernels of "name", or of the best supported instruction set if name is null
+bool select_isa(const char* name = nullptr) noexcept;
 
 
 #endif // BANDWIDTH_H
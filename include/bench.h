@@ -0,0 +1,69 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include "timer.h"
+#include "cold.h"
+#include "counters.h"
+#include "stats.h"
+#include "omp-helper.h"
+
+// kept in an anonymous namespace: every translation unit (and instruction set) has its own copy
+namespace {
+  template <class F>
+  float64_t bench(F&& f, int repeat = 1, int tries = 1) noexcept {
+    using counter_t = Timer::counter_t;
+    using diff_t = Timer::diff_t;
+
+    static diff_t dmin = -1, dmax = 0;
+    static bool converged = false;
+    const bool adaptive_tries = adaptive.enabled;
+    // cold caches: a single pass after the buffers are evicted
+    if (cold_enabled) repeat = 1;
+    OMP(master) {
+      dmin = -1;
+      dmax = 0;
+      samples_reset();
+      if (counters_enabled) counters_reset();
+    }
+    for (int i = 0; adaptive_tries || i < tries; i++) {
+      Timer::reset();
+      if (cold_enabled) cold_evict();
+      if (counters_enabled) {
+        OMP(master) counters_system_start();
+      }
+      OMP(barrier);
+      if (counters_enabled) counters_start();
+      asm volatile ("");
+      counter_t t0 = Timer::read();
+      for (int j = 0; j < repeat; j++) {
+        asm volatile ("");
+        f();
+        asm volatile ("");
+      }
+      counter_t t1 = Timer::read_end();
+      asm volatile ("");
+      if (counters_enabled) counters_stop();
+      diff_t d = Timer::diff(t0, t1);
+      OMP(critical) {
+        dmax = (dmax < 0 || d > dmax) ? d : dmax;
+      }
+      OMP(barrier);
+      OMP(master) {
+        if (counters_enabled) counters_system_stop(repeat, dmin < 0 || dmax < dmin);
+        samples_record(static_cast<float64_t>(dmax) / (repeat * Timer::frequency));
+        dmin = (dmin < 0 || dmax < dmin) ? dmax : dmin;
+        dmax = 0;
+        if (adaptive_tries) converged = i+1 >= tries && samples_converged();
+      }
+      if (adaptive_tries) {
+        // every thread reads the decision of the master before it can be overwritten
+        OMP(barrier);
+        bool stop = converged;
+        OMP(barrier);
+        if (stop) break;
+      }
+    }
+    return static_cast<float64_t>(dmin) / (repeat * Timer::frequency);
+  }
+}
+
+#endif // BENCH_H
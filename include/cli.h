@@ -0,0 +1,326 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "allocation.h"
+#include "counters.h"
+#include "gather.h"
+#include "loaded.h"
+#include "measure.h"
+#include "omp-helper.h"
+#include "placement.h"
+#include "stats.h"
+#include "types.h"
+
+// State and helpers of the command line tool shared by main.cpp and the modes (modes.h).
+
+/* OPTIONS */
+extern bool bytes_power_1024;
+extern bool verbose;
+extern bool CSV;
+extern bool first;
+extern bool latency_mode;
+extern bool loaded_mode;
+extern load_op loaded_op;
+extern bool traffic_mode;
+extern float64_t traffic_rate;     // bytes per second over all the threads (0: unlimited)
+extern float64_t traffic_writes;   // fraction of the bytes written
+extern float64_t traffic_duration; // seconds (0: until SIGINT or SIGTERM)
+extern bool numa_matrix;
+extern int current_cpu_node, current_mem_node;
+extern int max_threads;
+extern std::vector<int> thread_counts;
+extern affinity pinning;
+extern std::vector<int> allowed_cpus;
+extern std::ofstream stats_file;
+extern long long chase_stride;
+extern variant_filter filter;
+extern bool show_variants;
+extern std::vector<cache_level> caches;
+extern bool summary_only;
+extern bool summary_first;
+extern std::vector<bandwidth_type> types;
+extern std::vector<long long> prefetch_distances;
+extern std::vector<long long> strides;
+extern std::vector<index_pattern> patterns;
+// read:write mixes (arrays read, arrays written)
+extern std::vector<std::pair<int, int>> mixes;
+extern std::vector<int> stream_counts;
+extern bool memops_mode;
+extern std::vector<page_policy> page_policies;
+extern const char* coherence_cpus;
+extern const char* monitor_probes;
+extern float64_t monitor_interval;
+extern std::string monitor_history;
+extern float64_t monitor_threshold;
+extern std::string monitor_alert;
+extern long long stream_offset; // bytes added to the start of every array after the first one (array j: j * offset)
+
+constexpr int nb_ops = 7;
+extern const char* op_names[nb_ops];
+
+// calls X(T) for every element type of this build (eg: to instantiate the modes)
+#ifdef F16
+#define FOR_EACH_TYPE_F16(X) X(float16_t)
+#else
+#define FOR_EACH_TYPE_F16(X)
+#endif
+#define FOR_EACH_TYPE(X) FOR_EACH_TYPE_F16(X) X(float32_t) X(float64_t) X(int8_t) X(int16_t) X(int32_t) X(int64_t)
+
+template <class T>
+constexpr const char* name() noexcept {
+  return __PRETTY_FUNCTION__;
+}
+#ifdef F16
+template <> constexpr const char* name<float16_t>() noexcept { return "f16"; }
+#endif
+template <> constexpr const char* name<float32_t>() noexcept { return "f32"; }
+template <> constexpr const char* name<float64_t>() noexcept { return "f64"; }
+template <> constexpr const char* name<int8_t>() noexcept { return "i8"; }
+template <> constexpr const char* name<int16_t>() noexcept { return "i16"; }
+template <> constexpr const char* name<int32_t>() noexcept { return "i32"; }
+template <> constexpr const char* name<int64_t>() noexcept { return "i64"; }
+
+struct bytes {
+  float64_t n = 0;
+  bytes() = default;
+  bytes(float64_t n) : n(n) {}
+  bytes(const char* s) {
+    char* p = nullptr;
+    n = std::strtod(s, &p);
+    if (!p) return;
+    while (*p == ' ') ++p;
+    float64_t power = 1000.;
+    if (*p != 0 && p[1] == 'i') power = 1024.;
+    switch (*p) {
+      case 'f':
+        n /= power;
+        [[fallthrough]];
+      case 'p':
+        n /= power;
+        [[fallthrough]];
+      case 'n':
+        n /= power;
+        [[fallthrough]];
+      case 'u':
+        n /= power;
+        [[fallthrough]];
+      case 'm':
+        n /= power;
+        break;
+      case 'E':
+        n *= power;
+        [[fallthrough]];
+      case 'P':
+        n *= power;
+        [[fallthrough]];
+      case 'T':
+        n *= power;
+        [[fallthrough]];
+      case 'G':
+        n *= power;
+        [[fallthrough]];
+      case 'M':
+        n *= power;
+        [[fallthrough]];
+      case 'k':
+      case 'K':
+        n *= power;
+    }
+  }
+  friend std::ostream& operator<<(std::ostream& out, bytes B) {
+    float64_t b = B.n;
+    static const char letters[] = "\00fpnum KMGTPE\00";
+    const char* letter = letters+6;
+    float64_t power = bytes_power_1024 ? 1024. : 1000.;
+    while (letter[0] && letter[-1] && std::abs(b) < 1.) {
+      b *= power;
+      --letter;
+    }
+    while (letter[0] && letter[+1] && std::abs(b) > 999.) {
+      b /= power;
+      ++letter;
+    }
+    if (std::abs(b) < 1e-4) {
+      out << "0 ";
+      if (bytes_power_1024) out << ' ';
+      out << 'B';
+      return out;
+    }
+    out << b << ' ' << *letter;
+    if (bytes_power_1024) {
+      out << (*letter != ' ' ? 'i' : ' ');
+    }
+    out << 'B';
+    return out;
+  }
+
+  operator float64_t() const {
+    return n;
+  }
+};
+
+// bandwidth of one kernel variant
+struct variant {
+  int kern;
+  bool nontemporal;
+  float64_t bandwidth;
+  long long tries;
+};
+
+// the per-try durations and the hardware counts of the fastest variant are stored in "tries" and "events",
+// and the bandwidth of every variant is appended to "variants" (master thread only)
+// (the variants share the adaptive budget of the op)
+template <class T, class F>
+float64_t max_bandwidth(F&& f, std::vector<float64_t>* tries = nullptr, std::vector<variant>* variants = nullptr, counts* events = nullptr) {
+  float64_t max_bandwidth = -1./0.;
+  int count = 0;
+  for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
+    if (selected(b, sizeof(T), filter)) ++count;
+  }
+  OMP(master) samples_budget_split(count);
+  for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
+    if (!selected(b, sizeof(T), filter)) continue;
+    float64_t cur_bandwidth = f(b);
+    OMP(master) {
+      if (tries && cur_bandwidth > max_bandwidth) *tries = samples();
+      if (events && cur_bandwidth > max_bandwidth) *events = counters_read();
+      if (variants) variants->push_back({b->kern, b->nontemporal, cur_bandwidth, static_cast<long long>(samples().size())});
+    }
+    max_bandwidth = std::max(max_bandwidth, cur_bandwidth);
+  }
+  return max_bandwidth;
+}
+
+// fastest of the variants (non-empty)
+const variant& fastest(const std::vector<variant>& variants);
+// kernel variant of the background traffic: the fastest one selected by "variants" for "op" on f64 buffers of
+// "size" bytes (over "threads" threads), or the first one selected if the measure fails
+const bandwidth* fastest_variant(bandwidth_op op, long long size, int threads, const variant_filter& variants = filter);
+
+// writes the statistics of the tries of one op (the bytes moved per try are deduced from the best one)
+// (with the hardware counters, the counts per pass over the buffers of the fastest try)
+void print_stats(const char* type, float64_t size, int threads, const char* op, float64_t bandwidth, const std::vector<float64_t>& tries, const counts& events);
+
+void set_num_threads(int k);
+int get_num_threads();
+
+// every (size, number of threads) pair of the sweep
+struct point {
+  long long size;
+  int threads;
+};
+std::vector<point> sweep(const std::vector<long long>& sizes);
+
+// pins the k threads according to the affinity policy and returns their CPUs
+std::vector<int> pin_threads(int k);
+// binds every thread (up to max_threads) to the CPUs of the given nodes
+void bind_threads(const std::vector<int>& nodes);
+// binds every thread (up to max_threads) back to the given CPUs (eg: the allowed_cpus before a bind_threads())
+void restore_threads(const std::vector<int>& cpus);
+
+// allocates the buffer of a mode ("size" bytes, or "n" elements), or aborts: there is nothing to measure without it
+void* allocate_or_abort(long long size, long long alignment);
+template <class T>
+T* allocate_or_abort(long long n, long long alignment) {
+  return static_cast<T*>(allocate_or_abort(n * static_cast<long long>(sizeof(T)), std::max<long long>(alignment, alignof(T))));
+}
+[[noreturn]] void allocation_failed();
+
+std::string mix_name(std::pair<int, int> mix);
+// parses a list of element types (eg: f32,i64), "float", "int" and "all" select a whole family
+bool parse_types(const char* str, std::vector<bandwidth_type>& types);
+
+// run configuration that differs from the defaults (extra CSV columns or text details)
+// ("tries": the tries columns, printed with the adaptive measurement)
+void print_config_header(const std::string& tries = ",tries");
+void print_config_row(int threads, long long tries, bool with_tries = true);
+void print_config();
+// starts the output of a mode: its CSV header (once) or its title, followed by the run configuration
+void print_header(const std::string& columns, const std::string& title, const std::string& tries = ",tries");
+// text output: one point of the sweep ("details" after the size), its threads and with -v its repetitions,
+// tries (when fixed) and CPUs
+void print_point(float64_t size, int threads, int repeat, int tries, const std::vector<int>& cpus, const std::string& details = "");
+
+// total capacity of a cache level seen by "threads" threads (one instance per thread at most)
+long long cache_capacity(const cache_level& c, int threads);
+
+// median bandwidth of every op over the sizes that fit in each cache level (and over the ones that fit in none)
+template <size_t N>
+void print_summary(const char* type, const std::vector<point>& points, const std::vector<std::array<float64_t, N>>& results, const char* const* names) {
+  if (points.empty()) return;
+  int threads = 0;
+  for (const point& p : points) threads = std::max(threads, p.threads);
+
+  if (CSV) {
+    if (summary_first) {
+      std::cout << "type,level,size,threads";
+      for (unsigned op = 0; op < N; ++op) std::cout << ',' << names[op];
+      std::cout << std::endl;
+      summary_first = false;
+    }
+  } else {
+    std::cout << "Summary with type: " << type << " (threads: " << threads << ")" << std::endl;
+  }
+
+  long long lower = 0;
+  for (unsigned l = 0; l <= caches.size(); ++l) {
+    const bool dram = l == caches.size();
+    const long long capacity = dram ? 0 : cache_capacity(caches[l], threads);
+    // away from the boundaries: larger than the previous level, and leaving room in this one
+    std::vector<std::array<float64_t, N>> rows;
+    for (unsigned i = 0; i < points.size(); ++i) {
+      if (points[i].threads != threads) continue;
+      if (points[i].size <= lower + lower / 2) continue;
+      if (!dram && points[i].size > capacity - capacity / 4) continue;
+      rows.push_back(results[i]);
+    }
+    lower = capacity;
+
+    std::array<float64_t, N> median = {};
+    for (unsigned op = 0; op < N && !rows.empty(); ++op) {
+      std::vector<float64_t> bw;
+      for (const auto& row : rows) bw.push_back(row[op]);
+      median[op] = compute_stats(bw).median;
+    }
+
+    std::string level = dram ? "DRAM" : "L" + std::to_string(caches[l].level);
+    if (CSV) {
+      // empty fields when unknown
+      std::cout << type << ',' << level << ',';
+      if (!dram) std::cout << static_cast<float64_t>(capacity);
+      std::cout << ',' << threads;
+      for (unsigned op = 0; op < N; ++op) {
+        std::cout << ',';
+        if (!rows.empty()) std::cout << median[op];
+      }
+    } else {
+      std::cout << "  " << std::setw(4) << std::left << level << std::right << "  size: ";
+      if (dram) {
+        std::cout << "     -";
+      } else {
+        std::cout << std::setw(6) << bytes(capacity);
+      }
+      for (unsigned op = 0; op < N; ++op) {
+        std::cout << "  \t" << names[op] << ": ";
+        if (rows.empty()) {
+          std::cout << "     -";
+        } else {
+          std::cout << std::setw(6) << bytes(median[op]) << "/s";
+        }
+      }
+    }
+    std::cout << std::endl;
+  }
+}
+
+#endif // CLI_H
@@ -0,0 +1,19 @@
+#ifndef COHERENCE_H
+#define COHERENCE_H
+#include "types.h"
+
+// Cache line transfers between two threads pinned to cpu_a and cpu_b (returns 0 if a thread could not be
+// created or pinned).
+
+// one thread writes a line that the other one waits for and writes back, "rounds" round trips per try;
+// returns the minimum over "tries" of the one-way latency in seconds
+float64_t pingpong_latency(int cpu_a, int cpu_b, long long rounds, int tries = 1) noexcept;
+
+// the thread on cpu_a writes blocks of coherence_block bytes into a ring of coherence_slots slots that the
+// thread on cpu_b reads, "bytes" bytes per try; returns the maximum over "tries" of the bandwidth in bytes
+// per second
+constexpr long long coherence_block = 4096;
+constexpr int coherence_slots = 32;
+float64_t transfer_bandwidth(int cpu_a, int cpu_b, long long bytes, int tries = 1) noexcept;
+
+#endif // COHERENCE_H
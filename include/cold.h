@@ -0,0 +1,26 @@
+#ifndef COLD_H
+#define COLD_H
+
+// Cold-cache measurement: bench() evicts the buffers of the calling thread from the caches before every try
+// and times a single pass over them.
+
+enum class evict_method {
+  clflushopt, // x86, weakly ordered flushes (fenced once at the end)
+  clflush,    // x86
+  dc_civac,   // aarch64: clean and invalidate by address to the point of coherency
+  buffer      // reads of an eviction buffer twice the size of the largest cache
+};
+const char* evict_method_name(evict_method method);
+
+extern bool cold_enabled;
+// selects the eviction method (and allocates the eviction buffer if needed), returns false if it failed
+bool cold_init();
+evict_method cold_method() noexcept;
+
+// buffers evicted by cold_evict() (allocate() tracks them and deallocate() drops them while cold_enabled is set)
+void cold_track(const void* ptr, unsigned long long n) noexcept;
+void cold_untrack(const void* ptr) noexcept;
+// evicts the buffers allocated by the calling thread
+void cold_evict() noexcept;
+
+#endif // COLD_H
@@ -0,0 +1,41 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include "types.h"
+
+// hardware events counted (with perf_event_open) around the timed region of bench()
+enum counter_event {
+  ev_cycles,
+  ev_instructions,
+  ev_l1d_misses,
+  ev_llc_misses,
+  ev_dtlb_misses,
+  ev_dram_reads,  // uncore IMC CAS counts (system wide, in cache lines)
+  ev_dram_writes,
+  nb_events
+};
+const char* event_name(int event);
+
+extern bool counters_enabled;
+// opens the uncore counters and checks the core ones can be opened (returns false if none is available)
+bool counters_init() noexcept;
+// closes the counters of every thread (none can be used afterwards)
+void counters_fini() noexcept;
+
+// called by every thread around its timed region
+void counters_start() noexcept;
+void counters_stop() noexcept;
+// called by the master thread around the timed regions of all the threads (uncore counters),
+// keeps the counts of the try ("repeat" passes over the buffers) if it is the fastest one so far
+void counters_system_start() noexcept;
+void counters_system_stop(int repeat, bool fastest_try) noexcept;
+
+// counts of the events per pass over the buffers in the fastest try since counters_reset() (the duration
+// returned by bench()), summed over the threads, -1 if not available
+struct counts {
+  float64_t value[nb_events];
+};
+void counters_reset() noexcept;
+counts counters_read() noexcept;
+
+#endif // COUNTERS_H
@@ -0,0 +1,19 @@
+#ifndef GATHER_H
+#define GATHER_H
+#include "types.h"
+
+// patterns of the index arrays of the gather/scatter kernels (gather_bandwidth of bandwidth.h)
+enum class index_pattern { random, sorted, clustered };
+const char* pattern_name(index_pattern pattern);
+
+// fills idx[0..n) with indexes into an array of "m" elements:
+//  - random: uniformly distributed
+//  - sorted: uniformly distributed then sorted (increasing, with random gaps)
+//  - clustered: runs of cluster_size indexes in random order inside windows of cluster_span elements
+//    at random positions
+// returns false if the indexes do not fit 32 bits
+constexpr int cluster_size = 16;
+constexpr int cluster_span = 64;
+bool make_indexes(int32_t* idx, long long n, long long m, index_pattern pattern) noexcept;
+
+#endif // GATHER_H
@@ -0,0 +1,10 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+#include "types.h"
+
+// builds a random cyclic pointer chain with one link every "stride" bytes of the buffer
+void* make_chain(void* buffer, long long size, long long stride) noexcept;
+// walks n links of the chain and returns the time per load in seconds
+float64_t latency(void* chain, long long n, int repeat = 1, int tries = 1) noexcept;
+
+#endif // LATENCY_H
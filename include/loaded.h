@@ -0,0 +1,26 @@
+#ifndef LOADED_H
+#define LOADED_H
+#include "bandwidth.h"
+#include "types.h"
+
+// background traffic of the loaded latency (ops of the stream kernels)
+enum class load_op { read, copy, triad };
+const char* load_op_name(load_op op);
+
+// runs "op" with the kernel variant "b" (its untimed passes) over a buffer of "size" bytes, one chunk at a time,
+// until *stop becomes true, and waits after every chunk so that the kernel only runs a fraction "intensity"
+// of the time (0: idle, 1: saturated); returns the bandwidth (bytes per second) of the calling thread
+float64_t generate_load(load_op op, const bandwidth* b, void* buffer, long long size, float64_t intensity, const bool* stop) noexcept;
+
+// reads and writes a buffer of "size" bytes, one chunk at a time, until *stop becomes true: the kernel variant
+// "reader" reads the chunks and "writer" writes a fraction "writes" of the bytes, and the traffic is
+// throttled to "rate" bytes per second (0: unlimited); the bytes are added to *read and *written after
+// every chunk, so that another thread can report them periodically
+void generate_traffic(const bandwidth* reader, const bandwidth* writer, void* buffer, long long size, float64_t rate, float64_t writes,
+                      const bool* stop, unsigned long long* read, unsigned long long* written) noexcept;
+
+// walks n links of the chain "tries" times and returns the minimum time per load in seconds
+// (latency() of latency.h without synchronizing with the other threads, which generate the load)
+float64_t chase_latency(void* chain, long long n, int tries) noexcept;
+
+#endif // LOADED_H
@@ -0,0 +1,43 @@
+#ifndef MEASURE_C_H
+#define MEASURE_C_H
+
+/* C API of libbandwidth: measure() of measure.h with plain C types. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* same order as bandwidth_op and bandwidth_type of measure.h */
+typedef enum { BW_READ, BW_WRITE, BW_COPY, BW_INCR, BW_SCALE, BW_ADD, BW_TRIAD } bw_op;
+typedef enum { BW_F16, BW_F32, BW_F64, BW_I8, BW_I16, BW_I32, BW_I64 } bw_type;
+
+typedef struct {
+  double cost;     /* goal cost: higher means more tries */
+  int repeat;      /* repetitions per try (0: from the cost) */
+  int tries;       /* tries (0: from the cost) */
+  int temporal;    /* run the kernels with temporal stores */
+  int nontemporal; /* run the kernels with non-temporal stores */
+} bw_options;
+
+typedef struct {
+  const char* error; /* why the measure failed (NULL on success) */
+  double bandwidth;  /* bytes per second over all the threads */
+  double bytes;      /* bytes moved per pass over the buffers */
+  int kern;          /* fastest variant */
+  int nontemporal;
+  int repeat;
+  int tries;         /* tries of the fastest variant */
+  double min, median, mean, p95, stddev, cv; /* statistics of their durations (in seconds per pass) */
+} bw_result;
+
+/* default options of measure() */
+void bw_default_options(bw_options* options);
+/* measures the bandwidth of "op" on buffers of "size" bytes (over all the threads) with "threads" threads,
+   "options" may be NULL; returns 0 on success, -1 on failure (see result->error) */
+int bw_measure(bw_op op, bw_type type, long long size, int threads, const bw_options* options, bw_result* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEASURE_C_H */
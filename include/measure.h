@@ -0,0 +1,121 @@
+#ifndef MEASURE_H
+#define MEASURE_H
+
+#include <vector>
+#include "bandwidth.h"
+#include "stats.h"
+#include "types.h"
+
+// Entry point of libbandwidth: measures one op on buffers of one type, without any output.
+
+enum class bandwidth_op { read, write, copy, incr, scale, add, triad };
+enum class bandwidth_type { f16, f32, f64, i8, i16, i32, i64 };
+const char* op_name(bandwidth_op op);
+const char* type_name(bandwidth_type type);
+const char* hint_name(int hint); // prefetch_hint of bandwidth.h
+// bytes of one element (0 if the type is not supported by this build)
+int type_size(bandwidth_type type);
+
+// kernel variants run (and the fastest one kept)
+struct variant_filter {
+  bool temporal = true;    // kernels with temporal stores
+  bool nontemporal = true; // kernels with non-temporal stores
+  std::vector<int> kernels; // widths (elements per iteration), the ones that fit the SIMD registers if empty
+};
+// true if a kernel of this width does not fit the SIMD registers of the current instruction set
+// for elements of "elem_size" bytes
+bool cannot_be_fast(int kern, int elem_size);
+// true if the variant is run for elements of "elem_size" bytes
+bool selected(const bandwidth* b, int elem_size, const variant_filter& filter);
+
+inline unsigned long long round_down(unsigned long long n, int r) {
+  return (n/r) * r;
+}
+inline unsigned long long round_up(unsigned long long n, int r) {
+  return round_down(n-1, r)+r;
+}
+
+// number of repetitions per try and of tries for a goal cost and "n" elements per thread
+void get_repeat_tries(float64_t cost, long long n, int& repeat, int& tries);
+
+// buffers of one thread carved out of one allocation of "n" elements (plus 3 pages): A1 for the ops on one array,
+// A2/B2 on two, A3/B3/C3 on three, each array starting on its own page
+template <class T>
+struct buffers {
+  T *A1, *A2, *B2, *A3, *B3, *C3;
+  buffers(T* buffer, long long n) {
+    A1 = A2 = A3 = buffer;
+    B2 = reinterpret_cast<T*>(round_up(reinterpret_cast<unsigned long long>(A2 + (n+1)/2), 0x1000));
+    B3 = reinterpret_cast<T*>(round_up(reinterpret_cast<unsigned long long>(A3 + (n+2)/3), 0x1000));
+    C3 = reinterpret_cast<T*>(round_up(reinterpret_cast<unsigned long long>(B3 + (n+2)/3), 0x1000));
+  }
+};
+
+// bytes moved by one pass of "op" over the buffers of one thread (n elements in all, before the rounding
+// to the width of the kernel): every array is read or written once, incr reads and writes its one
+inline long long op_bytes(bandwidth_op op, long long n, int elem_size) {
+  switch (op) {
+    case bandwidth_op::read:
+    case bandwidth_op::write: return n * elem_size;
+    case bandwidth_op::copy:
+    case bandwidth_op::incr:
+    case bandwidth_op::scale: return 2 * (n/2) * elem_size;
+    case bandwidth_op::add:
+    case bandwidth_op::triad: return 3 * (n/3) * elem_size;
+  }
+  return 0;
+}
+
+// runs "op" with the kernel variant "b" on the buffers of one thread (n elements in all),
+// returns the bandwidth of this thread
+template <class T>
+float64_t run_op(const bandwidth* b, bandwidth_op op, const buffers<T>& x, long long n, int repeat, int tries) {
+  switch (op) {
+    case bandwidth_op::read:  return b->read(x.A1, round_down(n, b->kern), repeat, tries);
+    case bandwidth_op::write: return b->write(x.A1, round_down(n, b->kern), repeat, tries);
+    case bandwidth_op::copy:  return b->copy(x.A2, x.B2, round_down(n/2, b->kern), repeat, tries);
+    case bandwidth_op::incr:  return b->incr(x.A2, round_down(n/2, b->kern), repeat, tries);
+    case bandwidth_op::scale: return b->scale(x.A2, x.B2, round_down(n/2, b->kern), repeat, tries);
+    case bandwidth_op::add:   return b->add(x.A3, x.B3, x.C3, round_down(n/3, b->kern), repeat, tries);
+    case bandwidth_op::triad: return b->triad(x.A3, x.B3, x.C3, round_down(n/3, b->kern), repeat, tries);
+  }
+  return 0.;
+}
+// same with a software prefetch variant, "d" elements ahead
+template <class T>
+float64_t run_op(const prefetch_bandwidth* p, bandwidth_op op, const buffers<T>& x, long long n, long long d, int repeat, int tries) {
+  switch (op) {
+    case bandwidth_op::read:  return p->read(x.A1, round_down(n, p->kern), d, repeat, tries);
+    case bandwidth_op::write: return p->write(x.A1, round_down(n, p->kern), d, repeat, tries);
+    case bandwidth_op::copy:  return p->copy(x.A2, x.B2, round_down(n/2, p->kern), d, repeat, tries);
+    case bandwidth_op::incr:  return p->incr(x.A2, round_down(n/2, p->kern), d, repeat, tries);
+    case bandwidth_op::scale: return p->scale(x.A2, x.B2, round_down(n/2, p->kern), d, repeat, tries);
+    case bandwidth_op::add:   return p->add(x.A3, x.B3, x.C3, round_down(n/3, p->kern), d, repeat, tries);
+    case bandwidth_op::triad: return p->triad(x.A3, x.B3, x.C3, round_down(n/3, p->kern), d, repeat, tries);
+  }
+  return 0.;
+}
+
+struct measure_options {
+  float64_t cost = 1e6; // goal cost: higher means more tries
+  int repeat = 0;       // repetitions per try (0: from the cost)
+  int tries = 0;        // tries (0: from the cost, or until convergence with the adaptive mode of stats.h)
+  variant_filter variants;
+};
+
+struct measure_result {
+  const char* error = nullptr; // why the measure failed (nullptr on success)
+  float64_t bandwidth = 0.; // bytes per second over all the threads (0 if the measure failed)
+  float64_t bytes = 0.;     // bytes moved per pass over the buffers
+  int kern = 0;             // fastest variant
+  bool nontemporal = false;
+  int repeat = 0;
+  std::vector<float64_t> tries; // duration (in seconds per pass) of every try of the fastest variant
+  stats st;                     // statistics of these durations
+};
+
+// measures the bandwidth of "op" on buffers of "size" bytes (over all the threads) with "threads" threads
+// (selects the best instruction set if none has been selected yet)
+measure_result measure(bandwidth_op op, bandwidth_type type, long long size, int threads, const measure_options& options = {});
+
+#endif // MEASURE_H
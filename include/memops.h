@@ -0,0 +1,21 @@
+#ifndef MEMOPS_H
+#define MEMOPS_H
+#include "types.h"
+
+// copy and fill implementations of the C and C++ libraries (and of the string instructions of x86),
+// to compare with the copy and write kernels
+enum class copy_impl { memcpy, memmove, movsb, std_copy };
+enum class fill_impl { memset, stosb, std_fill };
+const char* copy_impl_name(copy_impl impl);
+const char* fill_impl_name(fill_impl impl);
+// false for the string instructions (rep movsb/stosb) outside of x86
+bool copy_impl_available(copy_impl impl) noexcept;
+bool fill_impl_available(fill_impl impl) noexcept;
+
+// copies A to B ("size" bytes each) and returns the bandwidth in bytes per second (read and write, as
+// the copy kernels); std::copy and std::fill work on integers of "elem_size" bytes (1, 2, 4 or 8)
+float64_t copy_bandwidth(copy_impl impl, const void* A, void* B, long long size, int elem_size, int repeat = 1, int tries = 1) noexcept;
+// fills A ("size" bytes) with zeros and returns the bandwidth in bytes per second
+float64_t fill_bandwidth(fill_impl impl, void* A, long long size, int elem_size, int repeat = 1, int tries = 1) noexcept;
+
+#endif // MEMOPS_H
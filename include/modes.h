@@ -0,0 +1,40 @@
+#ifndef MODES_H
+#define MODES_H
+
+#include <vector>
+#include "measure.h"
+#include "types.h"
+
+// The modes of the command line tool, each one printing its own results (cli.h).
+// The ones on elements of type T are instantiated for every type of FOR_EACH_TYPE.
+
+// bandwidth of every op over the sizes: the plain sweep, the comparison of the page policies (-p) or the
+// matrix of the NUMA nodes (-X)
+template <class T>
+void test_sweep(const std::vector<long long>& sizes, float64_t cost);
+// distance of the software prefetches (-F)
+template <class T>
+void test_prefetch(const std::vector<long long>& sizes, float64_t cost);
+// strided accesses (-R)
+template <class T>
+void test_strided(const std::vector<long long>& sizes, float64_t cost);
+// gather/scatter through an index array (-G), for the 32 and 64-bit types only
+void test_gather(bandwidth_type type, const std::vector<long long>& sizes, float64_t cost);
+// concurrent streams (-Z)
+template <class T>
+void test_streams(const std::vector<long long>& sizes, float64_t cost);
+// copies and fills of the libraries (-o)
+template <class T>
+void test_memops(const std::vector<long long>& sizes, float64_t cost);
+
+// pointer chasing latency (-l), and under the traffic of the other threads (-L)
+void test_latency(const std::vector<long long>& sizes, float64_t cost);
+void test_loaded(const std::vector<long long>& sizes, float64_t cost);
+// core-to-core latency and bandwidth matrices (-H)
+void test_coherence(float64_t cost);
+// traffic generator on buffers of "size" bytes (-g), until signalled
+void run_traffic(long long size);
+// periodic measures of the probes of "monitor_probes" (-Q), returns the exit status of the program
+int run_monitor(float64_t cost);
+
+#endif // MODES_H
@@ -0,0 +1,31 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "types.h"
+
+// Files of the monitoring mode: a rolling history of the measures and a per-host baseline.
+
+// name of the machine (from gethostname)
+std::string host_name();
+// current time as "2024-01-31T12:00:00Z"
+std::string utc_time();
+
+// best bandwidth of every probe op of a host (keyed by "probe:op"), taken over its first baseline_runs runs
+constexpr int baseline_runs = 3;
+struct baseline_entry {
+  float64_t bandwidth = 0.;
+  int runs = 0;
+};
+using baseline = std::map<std::string, baseline_entry>;
+// a missing file gives an empty baseline; returns false if the file cannot be parsed
+bool load_baseline(const std::string& path, baseline& base);
+bool save_baseline(const std::string& path, const baseline& base);
+
+// appends "rows" to the CSV file (writing "header" first if it is new) and keeps its last "limit" rows
+constexpr long long history_limit = 100000;
+bool append_history(const std::string& path, const std::string& header, const std::vector<std::string>& rows, long long limit = history_limit);
+
+#endif // MONITOR_H
@@ -0,0 +1,48 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <string>
+#include <vector>
+
+// parses a list like "0-3,8,10-11" ("all" gives an empty list)
+std::vector<int> parse_list(const char* s);
+
+// NUMA nodes (read from /sys/devices/system/node)
+std::vector<int> numa_nodes();
+std::vector<int> numa_cpu_nodes();
+std::vector<int> numa_node_cpus(int node);
+
+// formats a list as "0-3,8,10-11"
+std::string format_list(const std::vector<int>& list);
+
+// CPUs the process is allowed to run on
+std::vector<int> process_cpus();
+
+// thread pinning policies
+enum class affinity {
+  none,    // placement left to the OS (or OMP_PROC_BIND)
+  compact, // fills a socket before the next one, one thread per core first
+  scatter, // spreads the threads round-robin over the sockets and L3 domains
+  cores,   // one thread per physical core, SMT siblings left idle
+  smt      // both SMT siblings of a core before the next core
+};
+const char* affinity_name(affinity policy);
+// parses "none", "compact", "scatter", "cores" or "smt" (returns false if not recognized)
+bool parse_affinity(const char* s, affinity& policy);
+// CPU of each of the threads for the policy, chosen among the allowed CPUs
+std::vector<int> affinity_cpus(affinity policy, int threads, const std::vector<int>& allowed);
+
+// data (and unified) caches, read from /sys/devices/system/cpu/cpu*/cache
+struct cache_level {
+  int level;
+  long long size; // of one instance, in bytes
+  int instances;  // number of instances in the machine (eg: one per core or per socket)
+};
+std::vector<cache_level> cache_levels();
+
+// binds the calling thread to the given CPUs
+bool bind_thread(const std::vector<int>& cpus);
+// binds the calling thread to the CPUs of the given nodes
+bool bind_thread_to_nodes(const std::vector<int>& nodes);
+
+#endif // PLACEMENT_H
@@ -16,6 +16,22 @@
 #include <riscv_vector.h>
 #endif
 
+// The kernels can be compiled for several instruction sets in the same binary:
+// the inline namespace keeps the symbols of each instruction set apart.
+#if defined(__AVX512F__)
+#define SIMD_ISA isa_avx512
+#elif defined(__AVX2__)
+#define SIMD_ISA isa_avx2
+#elif defined(__AVX__)
+#define SIMD_ISA isa_avx
+#elif defined(__SSE2__)
+#define SIMD_ISA isa_sse2
+#else
+#define SIMD_ISA isa_generic
+#endif
+
+inline namespace SIMD_ISA {
+
 template <class T>
 struct load_addr {
   const T* p;
@@ -57,6 +73,14 @@ class simd {
     friend simd vfma(simd a, simd b, simd c) noexcept {
       return {vfma(a.low, b.low, c.low), vfma(a.high, b.high, c.high)};
     }
+    friend void vgather(simd& v, const T* base, const int32_t* idx) noexcept {
+      vgather(v.low, base, idx);
+      vgather(v.high, base, idx + N/2);
+    }
+    friend void vscatter(T* base, const int32_t* idx, simd v) noexcept {
+      vscatter(base, idx, v.low);
+      vscatter(base, idx + N/2, v.high);
+    }
     friend inline __attribute((always_inline)) void vkeep(simd a) noexcept {
       vkeep(a.low);
       vkeep(a.high);
@@ -95,8 +119,15 @@ class simd<T, 1> {
     friend simd vfma(simd a, simd b, simd c) noexcept {
       return simd(a.inner * b.inner + c.inner);
     }
+    friend void vgather(simd& v, const T* base, const int32_t* idx) noexcept {
+      v.inner = base[*idx];
+    }
+    friend void vscatter(T* base, const int32_t* idx, simd v) noexcept {
+      base[*idx] = v.inner;
+    }
+    // "+g" rather than "+X": GCC rejects "+X" on a value loaded through an index (gathers)
     friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
-      asm volatile ("" : "+X"(a.inner));
+      asm volatile ("" : "+g"(a.inner));
     }
 };
 
@@ -209,6 +240,170 @@ class simd<float64_t, 2> {
       asm volatile ("" : "+x"(a.inner));
     }
 };
+// integer multiplications (low half of the products) missing from SSE2
+inline __m128i vmullo_epi8(__m128i a, __m128i b) noexcept {
+  __m128i even = _mm_mullo_epi16(a, b);
+  __m128i odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+  return _mm_or_si128(_mm_slli_epi16(odd, 8), _mm_and_si128(even, _mm_set1_epi16(0xff)));
+}
+inline __m128i vmullo_epi32(__m128i a, __m128i b) noexcept {
+#ifdef __SSE4_1__
+  return _mm_mullo_epi32(a, b);
+#else
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+inline __m128i vmullo_epi64(__m128i a, __m128i b) noexcept {
+  __m128i low = _mm_mul_epu32(a, b);
+  __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+  return _mm_add_epi64(low, _mm_slli_epi64(cross, 32));
+}
+template <>
+class simd<int8_t, 16> {
+  private:
+    __m128i inner = _mm_setzero_si128();
+    simd(__m128i v) noexcept : inner(v) {}
+    operator __m128i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int8_t val) noexcept : inner(_mm_set1_epi8(val)) {}
+    simd(load_addr<int8_t> la) noexcept : inner(_mm_load_si128((const __m128i*)la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int8_t* p, simd v) noexcept {
+      _mm_store_si128((__m128i*)p, v);
+    }
+    friend void vstorent(int8_t* p, simd v) noexcept {
+      _mm_stream_si128((__m128i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm_add_epi8(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmullo_epi8(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm_add_epi8(vmul(a, b), c);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int16_t, 8> {
+  private:
+    __m128i inner = _mm_setzero_si128();
+    simd(__m128i v) noexcept : inner(v) {}
+    operator __m128i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int16_t val) noexcept : inner(_mm_set1_epi16(val)) {}
+    simd(load_addr<int16_t> la) noexcept : inner(_mm_load_si128((const __m128i*)la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int16_t* p, simd v) noexcept {
+      _mm_store_si128((__m128i*)p, v);
+    }
+    friend void vstorent(int16_t* p, simd v) noexcept {
+      _mm_stream_si128((__m128i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm_add_epi16(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return _mm_mullo_epi16(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm_add_epi16(vmul(a, b), c);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int32_t, 4> {
+  private:
+    __m128i inner = _mm_setzero_si128();
+    simd(__m128i v) noexcept : inner(v) {}
+    operator __m128i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int32_t val) noexcept : inner(_mm_set1_epi32(val)) {}
+    simd(load_addr<int32_t> la) noexcept : inner(_mm_load_si128((const __m128i*)la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int32_t* p, simd v) noexcept {
+      _mm_store_si128((__m128i*)p, v);
+    }
+    friend void vstorent(int32_t* p, simd v) noexcept {
+      _mm_stream_si128((__m128i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm_add_epi32(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmullo_epi32(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm_add_epi32(vmul(a, b), c);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int64_t, 2> {
+  private:
+    __m128i inner = _mm_setzero_si128();
+    simd(__m128i v) noexcept : inner(v) {}
+    operator __m128i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int64_t val) noexcept : inner(_mm_set1_epi64x(val)) {}
+    simd(load_addr<int64_t> la) noexcept : inner(_mm_load_si128((const __m128i*)la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int64_t* p, simd v) noexcept {
+      _mm_store_si128((__m128i*)p, v);
+    }
+    friend void vstorent(int64_t* p, simd v) noexcept {
+      _mm_stream_si128((__m128i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm_add_epi64(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmullo_epi64(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm_add_epi64(vmul(a, b), c);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
 #endif
 #ifdef __AVX__
 template <>
@@ -246,6 +441,12 @@ class simd<float32_t, 8> {
       return _mm256_add_ps(_mm256_mul_ps(a, b), c);
 #endif
     }
+#ifdef __AVX2__
+    // the gathers use the masked form with a zero source: GCC implements the plain one with an undefined source
+    friend void vgather(simd& v, const float32_t* base, const int32_t* idx) noexcept {
+      v.inner = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, _mm256_loadu_si256((const __m256i*)idx), _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4);
+    }
+#endif
     friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
       asm volatile ("" : "+x"(a.inner));
     }
@@ -286,11 +487,178 @@ class simd<float64_t, 4> {
       return _mm256_add_pd(_mm256_mul_pd(a, b), c);
 #endif
     }
+#ifdef __AVX2__
+    friend void vgather(simd& v, const float64_t* base, const int32_t* idx) noexcept {
+      v.inner = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, _mm_loadu_si128((const __m128i*)idx), _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+    }
+#endif
     friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
       asm volatile ("" : "+x"(a.inner));
     }
 };
 #endif
+#ifdef __AVX2__
+inline __m256i vmullo_epi8(__m256i a, __m256i b) noexcept {
+  __m256i even = _mm256_mullo_epi16(a, b);
+  __m256i odd = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+  return _mm256_or_si256(_mm256_slli_epi16(odd, 8), _mm256_and_si256(even, _mm256_set1_epi16(0xff)));
+}
+inline __m256i vmullo_epi64(__m256i a, __m256i b) noexcept {
+  __m256i low = _mm256_mul_epu32(a, b);
+  __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+  return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+template <>
+class simd<int8_t, 32> {
+  private:
+    __m256i inner = _mm256_setzero_si256();
+    simd(__m256i v) noexcept : inner(v) {}
+    operator __m256i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int8_t val) noexcept : inner(_mm256_set1_epi8(val)) {}
+    simd(load_addr<int8_t> la) noexcept : inner(_mm256_load_si256((const __m256i*)la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int8_t* p, simd v) noexcept {
+      _mm256_store_si256((__m256i*)p, v);
+    }
+    friend void vstorent(int8_t* p, simd v) noexcept {
+      _mm256_stream_si256((__m256i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm256_add_epi8(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmullo_epi8(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm256_add_epi8(vmul(a, b), c);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int16_t, 16> {
+  private:
+    __m256i inner = _mm256_setzero_si256();
+    simd(__m256i v) noexcept : inner(v) {}
+    operator __m256i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int16_t val) noexcept : inner(_mm256_set1_epi16(val)) {}
+    simd(load_addr<int16_t> la) noexcept : inner(_mm256_load_si256((const __m256i*)la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int16_t* p, simd v) noexcept {
+      _mm256_store_si256((__m256i*)p, v);
+    }
+    friend void vstorent(int16_t* p, simd v) noexcept {
+      _mm256_stream_si256((__m256i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm256_add_epi16(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return _mm256_mullo_epi16(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm256_add_epi16(vmul(a, b), c);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int32_t, 8> {
+  private:
+    __m256i inner = _mm256_setzero_si256();
+    simd(__m256i v) noexcept : inner(v) {}
+    operator __m256i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int32_t val) noexcept : inner(_mm256_set1_epi32(val)) {}
+    simd(load_addr<int32_t> la) noexcept : inner(_mm256_load_si256((const __m256i*)la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int32_t* p, simd v) noexcept {
+      _mm256_store_si256((__m256i*)p, v);
+    }
+    friend void vstorent(int32_t* p, simd v) noexcept {
+      _mm256_stream_si256((__m256i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm256_add_epi32(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return _mm256_mullo_epi32(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm256_add_epi32(vmul(a, b), c);
+    }
+    friend void vgather(simd& v, const int32_t* base, const int32_t* idx) noexcept {
+      v.inner = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int*)base, _mm256_loadu_si256((const __m256i*)idx), _mm256_set1_epi32(-1), 4);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int64_t, 4> {
+  private:
+    __m256i inner = _mm256_setzero_si256();
+    simd(__m256i v) noexcept : inner(v) {}
+    operator __m256i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int64_t val) noexcept : inner(_mm256_set1_epi64x(val)) {}
+    simd(load_addr<int64_t> la) noexcept : inner(_mm256_load_si256((const __m256i*)la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int64_t* p, simd v) noexcept {
+      _mm256_store_si256((__m256i*)p, v);
+    }
+    friend void vstorent(int64_t* p, simd v) noexcept {
+      _mm256_stream_si256((__m256i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm256_add_epi64(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmullo_epi64(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm256_add_epi64(vmul(a, b), c);
+    }
+    friend void vgather(simd& v, const int64_t* base, const int32_t* idx) noexcept {
+      v.inner = _mm256_mask_i32gather_epi64(_mm256_setzero_si256(), (const long long*)base, _mm_loadu_si128((const __m128i*)idx), _mm256_set1_epi64x(-1), 8);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+#endif // __AVX2__
 #ifdef __AVX512F__
 template <>
 class simd<float32_t, 16> {
@@ -323,6 +691,12 @@ class simd<float32_t, 16> {
     friend simd vfma(simd a, simd b, simd c) noexcept {
       return _mm512_fmadd_ps(a, b, c);
     }
+    friend void vgather(simd& v, const float32_t* base, const int32_t* idx) noexcept {
+      v.inner = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xffff, _mm512_loadu_si512(idx), base, 4);
+    }
+    friend void vscatter(float32_t* base, const int32_t* idx, simd v) noexcept {
+      _mm512_i32scatter_ps(base, _mm512_loadu_si512(idx), v, 4);
+    }
     friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
       asm volatile ("" : "+x"(a.inner));
     }
@@ -359,10 +733,180 @@ class simd<float64_t, 8> {
     friend simd vfma(simd a, simd b, simd c) noexcept {
       return _mm512_fmadd_pd(a, b, c);
     }
+    friend void vgather(simd& v, const float64_t* base, const int32_t* idx) noexcept {
+      v.inner = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xff, _mm256_loadu_si256((const __m256i*)idx), base, 8);
+    }
+    friend void vscatter(float64_t* base, const int32_t* idx, simd v) noexcept {
+      _mm512_i32scatter_pd(base, _mm256_loadu_si256((const __m256i*)idx), v, 8);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int32_t, 16> {
+  private:
+    __m512i inner = _mm512_setzero_si512();
+    simd(__m512i v) noexcept : inner(v) {}
+    operator __m512i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int32_t val) noexcept : inner(_mm512_set1_epi32(val)) {}
+    simd(load_addr<int32_t> la) noexcept : inner(_mm512_load_si512(la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int32_t* p, simd v) noexcept {
+      _mm512_store_si512(p, v);
+    }
+    friend void vstorent(int32_t* p, simd v) noexcept {
+      _mm512_stream_si512((__m512i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm512_add_epi32(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return _mm512_mullo_epi32(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm512_add_epi32(vmul(a, b), c);
+    }
+    friend void vgather(simd& v, const int32_t* base, const int32_t* idx) noexcept {
+      v.inner = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xffff, _mm512_loadu_si512(idx), base, 4);
+    }
+    friend void vscatter(int32_t* base, const int32_t* idx, simd v) noexcept {
+      _mm512_i32scatter_epi32(base, _mm512_loadu_si512(idx), v, 4);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int64_t, 8> {
+  private:
+    __m512i inner = _mm512_setzero_si512();
+    simd(__m512i v) noexcept : inner(v) {}
+    operator __m512i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int64_t val) noexcept : inner(_mm512_set1_epi64(val)) {}
+    simd(load_addr<int64_t> la) noexcept : inner(_mm512_load_si512(la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int64_t* p, simd v) noexcept {
+      _mm512_store_si512(p, v);
+    }
+    friend void vstorent(int64_t* p, simd v) noexcept {
+      _mm512_stream_si512((__m512i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm512_add_epi64(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return _mm512_mullox_epi64(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm512_add_epi64(vmul(a, b), c);
+    }
+    friend void vgather(simd& v, const int64_t* base, const int32_t* idx) noexcept {
+      v.inner = _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), 0xff, _mm256_loadu_si256((const __m256i*)idx), base, 8);
+    }
+    friend void vscatter(int64_t* base, const int32_t* idx, simd v) noexcept {
+      _mm512_i32scatter_epi64(base, _mm256_loadu_si256((const __m256i*)idx), v, 8);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+// 8 and 16-bit integers need AVX512BW (without it, the 256-bit halves are used)
+#ifdef __AVX512BW__
+inline __m512i vmullo_epi8(__m512i a, __m512i b) noexcept {
+  __m512i even = _mm512_mullo_epi16(a, b);
+  __m512i odd = _mm512_mullo_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8));
+  return _mm512_or_si512(_mm512_slli_epi16(odd, 8), _mm512_and_si512(even, _mm512_set1_epi16(0xff)));
+}
+template <>
+class simd<int8_t, 64> {
+  private:
+    __m512i inner = _mm512_setzero_si512();
+    simd(__m512i v) noexcept : inner(v) {}
+    operator __m512i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int8_t val) noexcept : inner(_mm512_set1_epi8(val)) {}
+    simd(load_addr<int8_t> la) noexcept : inner(_mm512_load_si512(la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int8_t* p, simd v) noexcept {
+      _mm512_store_si512(p, v);
+    }
+    friend void vstorent(int8_t* p, simd v) noexcept {
+      _mm512_stream_si512((__m512i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm512_add_epi8(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmullo_epi8(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm512_add_epi8(vmul(a, b), c);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+x"(a.inner));
+    }
+};
+template <>
+class simd<int16_t, 32> {
+  private:
+    __m512i inner = _mm512_setzero_si512();
+    simd(__m512i v) noexcept : inner(v) {}
+    operator __m512i() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int16_t val) noexcept : inner(_mm512_set1_epi16(val)) {}
+    simd(load_addr<int16_t> la) noexcept : inner(_mm512_load_si512(la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int16_t* p, simd v) noexcept {
+      _mm512_store_si512(p, v);
+    }
+    friend void vstorent(int16_t* p, simd v) noexcept {
+      _mm512_stream_si512((__m512i*)p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return _mm512_add_epi16(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return _mm512_mullo_epi16(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return _mm512_add_epi16(vmul(a, b), c);
+    }
     friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
       asm volatile ("" : "+x"(a.inner));
     }
 };
+#endif // __AVX512BW__
 #endif
 #ifdef __ARM_NEON
 #ifdef F16
@@ -517,6 +1061,115 @@ class simd<float32_t, 4> {
       asm volatile ("" : "+w"(a.inner));
     }
 };
+// integers (64-bit ones have no NEON multiplication: their scalar version is used)
+template <>
+class simd<int8_t, 16> {
+  private:
+    int8x16_t inner = vdupq_n_s8(0);
+    simd(int8x16_t v) noexcept : inner(v) {}
+    operator int8x16_t() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int8_t val) noexcept : inner(vdupq_n_s8(val)) {}
+    simd(load_addr<int8_t> la) noexcept : inner(vld1q_s8(la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int8_t* p, simd v) noexcept {
+      vst1q_s8(p, v);
+    }
+    friend void vstorent(int8_t* p, simd v) noexcept {
+      vst1q_s8(p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return vaddq_s8(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmulq_s8(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return vmlaq_s8(c, a, b);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+w"(a.inner));
+    }
+};
+template <>
+class simd<int16_t, 8> {
+  private:
+    int16x8_t inner = vdupq_n_s16(0);
+    simd(int16x8_t v) noexcept : inner(v) {}
+    operator int16x8_t() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int16_t val) noexcept : inner(vdupq_n_s16(val)) {}
+    simd(load_addr<int16_t> la) noexcept : inner(vld1q_s16(la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int16_t* p, simd v) noexcept {
+      vst1q_s16(p, v);
+    }
+    friend void vstorent(int16_t* p, simd v) noexcept {
+      vst1q_s16(p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return vaddq_s16(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmulq_s16(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return vmlaq_s16(c, a, b);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+w"(a.inner));
+    }
+};
+template <>
+class simd<int32_t, 4> {
+  private:
+    int32x4_t inner = vdupq_n_s32(0);
+    simd(int32x4_t v) noexcept : inner(v) {}
+    operator int32x4_t() const noexcept {
+      return inner;
+    }
+  public:
+    explicit simd(int32_t val) noexcept : inner(vdupq_n_s32(val)) {}
+    simd(load_addr<int32_t> la) noexcept : inner(vld1q_s32(la.p)) {}
+    simd() = default;
+    simd(const simd&) = default;
+    simd& operator=(const simd&) = default;
+    ~simd() = default;
+
+    friend void vstore(int32_t* p, simd v) noexcept {
+      vst1q_s32(p, v);
+    }
+    friend void vstorent(int32_t* p, simd v) noexcept {
+      vst1q_s32(p, v);
+    }
+
+    friend simd vadd(simd a, simd b) noexcept {
+      return vaddq_s32(a, b);
+    }
+    friend simd vmul(simd a, simd b) noexcept {
+      return vmulq_s32(a, b);
+    }
+    friend simd vfma(simd a, simd b, simd c) noexcept {
+      return vmlaq_s32(c, a, b);
+    }
+    friend inline __attribute((always_inline)) void vkeep(simd& a) noexcept {
+      asm volatile ("" : "+w"(a.inner));
+    }
+};
 #ifdef __aarch64__
 template <>
 class simd<float64_t, 2> {
@@ -786,5 +1439,21 @@ simd<T, N> vload(const T* p) {
   return vload(p);
 }
 
+// gather (v[i] = base[idx[i]]) and scatter (base[idx[i]] = v[i]) one element at a time, for the
+// registers without gather or scatter instructions (the ones with them define their own overloads)
+template <class T, int N>
+void vgather(simd<T, N>& v, const T* base, const int32_t* idx) noexcept {
+  alignas(64) T tmp[N];
+  for (int i = 0; i < N; ++i) tmp[i] = base[idx[i]];
+  v = simd<T, N>(vload(static_cast<const T*>(tmp)));
+}
+template <class T, int N>
+void vscatter(T* base, const int32_t* idx, simd<T, N> v) noexcept {
+  alignas(64) T tmp[N];
+  vstore(tmp, v);
+  for (int i = 0; i < N; ++i) base[idx[i]] = tmp[i];
+}
+
+} // inline namespace SIMD_ISA
 
 #endif
@@ -0,0 +1,36 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <vector>
+#include "types.h"
+
+// Duration (in seconds per repeat) of every try timed by bench().
+// Only the master thread records and reads them.
+void samples_reset() noexcept;
+void samples_record(float64_t seconds) noexcept;
+const std::vector<float64_t>& samples();
+// number of tries recorded since the start of the program
+long long samples_total() noexcept;
+
+// adaptive measurement: bench() keeps running tries until the samples converge
+struct convergence {
+  bool enabled = false;
+  int min_tries = 5;
+  int max_tries = 100000;
+  float64_t target = 0.01; // relative half-width of the 95% confidence interval of the median
+  float64_t budget = 1.;   // maximum time (in seconds) spent on one op, shared by its kernel variants
+};
+extern convergence adaptive;
+// shares the budget among the next "measures" measurements (the kernel variants of one op): each one may use
+// what is left of it divided by the measurements left (without it, every measurement gets the whole budget)
+void samples_budget_split(int measures) noexcept;
+// true when the recorded samples converged (or the budget is exhausted)
+bool samples_converged() noexcept;
+
+struct stats {
+  int count = 0;
+  float64_t min = 0., median = 0., mean = 0., p95 = 0., stddev = 0., cv = 0.;
+};
+stats compute_stats(std::vector<float64_t> samples);
+
+#endif // STATS_H
@@ -6,6 +6,8 @@
 #define restrict __restrict__
 #endif
 
+inline namespace SIMD_ISA {
+
 template <int N = 1, bool nt = false>
 struct stream {
   constexpr static int kern = N;
@@ -144,6 +146,29 @@ struct stream {
       }
     }
   }
+
+  // reads the k arrays A, A+s, ... and writes their sum to the w arrays B, B+s, ... (k:w read/write mix)
+  template <class T>
+  static void mix(const T*restrict A, T*restrict B, long long n, long long s, int k, int w) {
+    using vec = simd<T, N>;
+    long long i;
+
+    for (i = 0; i < n; i += N) {
+      vec a(0);
+      for (int j = 0; j < k; ++j) {
+        vec b = vload(&A[j*s + i]);
+        a = vadd(a, b);
+      }
+      if (w == 0) vkeep(a);
+      for (int j = 0; j < w; ++j) {
+        if (nt) {
+          vstorent(&B[j*s + i], a);
+        } else {
+          vstore(&B[j*s + i], a);
+        }
+      }
+    }
+  }
 };
 
 
@@ -201,6 +226,292 @@ struct stream<1, false> {
       C[i] = scalar * A[i] + B[i];
     }
   }
+
+  template <class T>
+  static void mix(const T*restrict A, T*restrict B, long long n, long long s, int k, int w) {
+    for (long long i = 0; i < n; ++i) {
+      T a = 0;
+      for (int j = 0; j < k; ++j) {
+        a = a + A[j*s + i];
+      }
+      if (w == 0) asm volatile ("" :"+X"(a));
+      for (int j = 0; j < w; ++j) {
+        B[j*s + i] = a;
+      }
+    }
+  }
+};
+
+
+// stream kernels (temporal stores) that prefetch the lines "d" elements ahead of the accesses,
+// on top of the hardware prefetchers ("hint": locality of __builtin_prefetch, see prefetch_hint)
+// (the last iterations, whose lines ahead would be past the end of the arrays, do not prefetch)
+template <int N, int hint>
+struct prefetch_stream {
+  constexpr static int kern = N;
+
+  // one prefetch per cache line of an iteration (rw: 1 for the lines about to be written)
+  template <int rw, class T>
+  static inline __attribute((always_inline)) void ahead(const T* p) {
+    for (int k = 0; k < (int)(N * sizeof(T)); k += 64) {
+      __builtin_prefetch(reinterpret_cast<const char*>(p) + k, rw, hint);
+    }
+  }
+
+  template <class T>
+  static void read(const T*restrict A, long long n, long long d) {
+    using vec = simd<T, N>;
+    long long i;
+
+    for (i = 0; i < n - d - (N-1); i += N) {
+      ahead<0>(&A[i + d]);
+      vec a = vload(&A[i]);
+      vkeep(a);
+    }
+    for (; i < n; i += N) {
+      vec a = vload(&A[i]);
+      vkeep(a);
+    }
+  }
+
+  template <class T>
+  static void write(T*restrict A, long long n, long long d) {
+    using vec = simd<T, N>;
+    long long i;
+    vec a(0);
+
+    for (i = 0; i < n - d - (N-1); i += N) {
+      ahead<1>(&A[i + d]);
+      vstore(&A[i], a);
+    }
+    for (; i < n; i += N) {
+      vstore(&A[i], a);
+    }
+  }
+
+  template <class T>
+  static void copy(const T*restrict A, T*restrict B, long long n, long long d) {
+    using vec = simd<T, N>;
+    long long i;
+
+    for (i = 0; i < n - d - (N-1); i += N) {
+      ahead<0>(&A[i + d]);
+      ahead<1>(&B[i + d]);
+      vec a = vload(&A[i]);
+      vstore(&B[i], a);
+    }
+    for (; i < n; i += N) {
+      vec a = vload(&A[i]);
+      vstore(&B[i], a);
+    }
+  }
+
+  template <class T>
+  static void incr(T*restrict A, long long n, long long d) {
+    using vec = simd<T, N>;
+    vec vone(static_cast<T>(1));
+    long long i;
+
+    for (i = 0; i < n - d - (N-1); i += N) {
+      ahead<1>(&A[i + d]);
+      vec a1 = vload(&A[i]);
+      vec a2 = vadd(a1, vone);
+      vstore(&A[i], a2);
+    }
+    for (; i < n; i += N) {
+      vec a1 = vload(&A[i]);
+      vec a2 = vadd(a1, vone);
+      vstore(&A[i], a2);
+    }
+  }
+
+  template <class T>
+  static void scale(T scalar, const T*restrict A, T*restrict B, long long n, long long d) {
+    using vec = simd<T, N>;
+    vec vscalar(scalar);
+    long long i;
+
+    for (i = 0; i < n - d - (N-1); i += N) {
+      ahead<0>(&A[i + d]);
+      ahead<1>(&B[i + d]);
+      vec a = vload(&A[i]);
+      vec b = vmul(vscalar, a);
+      vstore(&B[i], b);
+    }
+    for (; i < n; i += N) {
+      vec a = vload(&A[i]);
+      vec b = vmul(vscalar, a);
+      vstore(&B[i], b);
+    }
+  }
+
+  template <class T>
+  static void add(const T*restrict A, const T*restrict B, T*restrict C, long long n, long long d) {
+    using vec = simd<T, N>;
+    long long i;
+
+    for (i = 0; i < n - d - (N-1); i += N) {
+      ahead<0>(&A[i + d]);
+      ahead<0>(&B[i + d]);
+      ahead<1>(&C[i + d]);
+      vec a = vload(&A[i]);
+      vec b = vload(&B[i]);
+      vec c = vadd(a, b);
+      vstore(&C[i], c);
+    }
+    for (; i < n; i += N) {
+      vec a = vload(&A[i]);
+      vec b = vload(&B[i]);
+      vec c = vadd(a, b);
+      vstore(&C[i], c);
+    }
+  }
+
+  template <class T>
+  static void triad(T scalar, const T*restrict A, const T*restrict B, T*restrict C, long long n, long long d) {
+    using vec = simd<T, N>;
+    vec vscalar(scalar);
+    long long i;
+
+    for (i = 0; i < n - d - (N-1); i += N) {
+      ahead<0>(&A[i + d]);
+      ahead<0>(&B[i + d]);
+      ahead<1>(&C[i + d]);
+      vec a = vload(&A[i]);
+      vec b = vload(&B[i]);
+      vec c = vfma(vscalar, a, b);
+      vstore(&C[i], c);
+    }
+    for (; i < n; i += N) {
+      vec a = vload(&A[i]);
+      vec b = vload(&B[i]);
+      vec c = vfma(vscalar, a, b);
+      vstore(&C[i], c);
+    }
+  }
+};
+
+
+struct chase {
+  // follows n links of a pointer chain: every load depends on the previous one
+  static void* walk(void* p, long long n) {
+    void** q = static_cast<void**>(p);
+    long long i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+      q = static_cast<void**>(*q);
+      q = static_cast<void**>(*q);
+      q = static_cast<void**>(*q);
+      q = static_cast<void**>(*q);
+      q = static_cast<void**>(*q);
+      q = static_cast<void**>(*q);
+      q = static_cast<void**>(*q);
+      q = static_cast<void**>(*q);
+    }
+    for (; i < n; ++i) {
+      q = static_cast<void**>(*q);
+    }
+    return q;
+  }
 };
 
+struct strided {
+  // accesses one (integer) element every "s" elements ("n" accesses), unrolled 4 times so that
+  // the loop itself does not limit the small strides
+  template <class T>
+  static void read(const T*restrict A, long long n, long long s) {
+    long long i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+      T a0 = A[(i+0)*s], a1 = A[(i+1)*s], a2 = A[(i+2)*s], a3 = A[(i+3)*s];
+      asm volatile ("" :"+r"(a0));
+      asm volatile ("" :"+r"(a1));
+      asm volatile ("" :"+r"(a2));
+      asm volatile ("" :"+r"(a3));
+    }
+    for (; i < n; ++i) {
+      T a = A[i*s];
+      asm volatile ("" :"+r"(a));
+    }
+  }
+
+  template <class T>
+  static void write(T*restrict A, long long n, long long s) {
+    T a = 0;
+    long long i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+      A[(i+0)*s] = a;
+      A[(i+1)*s] = a;
+      A[(i+2)*s] = a;
+      A[(i+3)*s] = a;
+    }
+    for (; i < n; ++i) {
+      A[i*s] = a;
+    }
+  }
+
+  template <class T>
+  static void copy(const T*restrict A, T*restrict B, long long n, long long s) {
+    long long i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+      B[(i+0)*s] = A[(i+0)*s];
+      B[(i+1)*s] = A[(i+1)*s];
+      B[(i+2)*s] = A[(i+2)*s];
+      B[(i+3)*s] = A[(i+3)*s];
+    }
+    for (; i < n; ++i) {
+      B[i*s] = A[i*s];
+    }
+  }
+};
+
+template <int N = 1>
+struct indexed {
+  constexpr static int kern = N;
+
+  // x = A[idx[i]]
+  template <class T>
+  static void gather(const T*restrict A, const int32_t*restrict idx, long long n) {
+    using vec = simd<T, N>;
+    long long i;
+
+    for (i = 0; i < n; i += N) {
+      vec a(0);
+      vgather(a, A, &idx[i]);
+      vkeep(a);
+    }
+  }
+
+  // A[idx[i]] = x
+  template <class T>
+  static void scatter(T*restrict A, const int32_t*restrict idx, long long n) {
+    using vec = simd<T, N>;
+    long long i;
+    vec a(0);
+
+    for (i = 0; i < n; i += N) {
+      vscatter(A, &idx[i], a);
+    }
+  }
+
+  // C[i] = A[idx[i]] + B[i]
+  template <class T>
+  static void gather_add(const T*restrict A, const int32_t*restrict idx, const T*restrict B, T*restrict C, long long n) {
+    using vec = simd<T, N>;
+    long long i;
+
+    for (i = 0; i < n; i += N) {
+      vec a(0);
+      vgather(a, A, &idx[i]);
+      vec b = vload(&B[i]);
+      vec c = vadd(a, b);
+      vstore(&C[i], c);
+    }
+  }
+};
+
+} // inline namespace SIMD_ISA
+
 #endif // STREAM_H
@@ -0,0 +1,16 @@
+#ifndef STRIDED_H
+#define STRIDED_H
+#include "types.h"
+
+// accesses "n" elements of "elem_size" bytes (1, 2, 4 or 8), one every "stride" bytes,
+// and returns the useful bandwidth in bytes per second (bytes of the elements accessed)
+float64_t strided_read(const void* A, int elem_size, long long stride, long long n, int repeat = 1, int tries = 1) noexcept;
+float64_t strided_write(void* A, int elem_size, long long stride, long long n, int repeat = 1, int tries = 1) noexcept;
+float64_t strided_copy(const void* A, void* B, int elem_size, long long stride, long long n, int repeat = 1, int tries = 1) noexcept;
+
+// cache lines of "line" bytes touched per array by n accesses every "stride" bytes
+inline float64_t strided_lines(long long stride, long long n, long long line = 64) noexcept {
+  return stride < line ? static_cast<float64_t>(n) * stride / line : static_cast<float64_t>(n);
+}
+
+#endif // STRIDED_H
@@ -9,12 +9,16 @@ struct Timer {
     using diff_t = signed long long int;
   public:
     static void reset(void) noexcept {}
+    // start and end of a timed region (serialized with lfence and rdtscp on x86)
     static counter_t read(void) noexcept;
+    static counter_t read_end(void) noexcept;
   private:
     static diff_t overhead;
   public:
     static float64_t frequency;
     static bool low_overhead;
+    // the counter ticks at a constant rate whatever the frequency and power state of the core
+    static bool invariant;
     static diff_t diff(counter_t t0, counter_t t1) noexcept {
       diff_t d = (diff_t) t1 - (diff_t) t0 - overhead;
       return (d <= 0) ? 1 : d;
@@ -1,6 +1,8 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <stdint.h> // int8_t, int16_t, int32_t, int64_t
+
 using float32_t = float;
 using float64_t = double;
 
@@ -84,6 +84,7 @@ parser.add_argument('--L1', type=str, default="0", help='L1 cache size in bytes
 parser.add_argument('--L2', type=str, default="0", help='L2 cache size in bytes ("xx KB", "xx MB" & "xx GB" are accepted)')
 parser.add_argument('--L3', type=str, default="0", help='L3 cache size in bytes ("xx KB", "xx MB" & "xx GB" are accepted)')
 parser.add_argument('--L4', type=str, default="0", help='L4 cache size in bytes ("xx KB", "xx MB" & "xx GB" are accepted)')
+parser.add_argument('--caches', dest='caches', default=False, help='reads the cache sizes (not given with --L*) of this machine from /sys/devices/system/cpu', action='store_true')
 group = parser.add_mutually_exclusive_group()
 group.add_argument('-l', '--linear', dest='linear', default=False, help='linear scale for Y axis', action='store_true')
 group.add_argument('-L', '--log', dest='linear', help='log scale for Y axis', action='store_false')
@@ -153,6 +154,23 @@ def human2bytes(s):
       raise RuntimeError("Unsupported format:'" + s + "'")
   return value;
 
+if args.caches:
+  import glob
+  for index in sorted(glob.glob('/sys/devices/system/cpu/cpu0/cache/index*')):
+    try:
+      with open(index + '/level') as f: level = int(f.read())
+      with open(index + '/type') as f: type = f.read().strip()
+      with open(index + '/size') as f: size = f.read().strip()
+    except (OSError, ValueError):
+      continue
+    name = 'L{}'.format(level)
+    if type == 'Instruction' or not hasattr(args, name) or getattr(args, name) != "0":
+      continue
+    # eg: "48K" -> "48 KB"
+    if size[-1] in 'KMG':
+      size = size[:-1] + ' ' + size[-1] + 'B'
+    setattr(args, name, size)
+
 raw_caches = [0., human2bytes(args.L1)*args.xscale, human2bytes(args.L2)*args.xscale, human2bytes(args.L3)*args.xscale, human2bytes(args.L4)*args.xscale]
 caches = [0.]
 
@@ -3,19 +3,201 @@
 #define _GNU_SOURCE
 #endif
 #include <cstdlib>
-#include <iostream>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include "allocation.h"
+#include "cold.h"
+#include "placement.h"
 
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+#endif
+
+static mem_policy policy = mem_policy::local;
+static std::vector<unsigned long> nodemask;
+static page_policy pages = page_policy::system;
+// hugetlb mappings must be released with munmap: remember their size
+static std::mutex mappings_mutex;
+static std::map<void*, unsigned long long int> mappings;
+static void (*allocation_log)(const char*) = nullptr;
+
+void set_allocation_log(void (*log)(const char* message)) {
+  allocation_log = log;
+}
+
+static void report(const std::ostringstream& message) {
+  if (allocation_log) allocation_log(message.str().c_str());
+}
+
+void set_mem_policy(mem_policy p, const std::vector<int>& nodes) {
+  policy = p;
+  nodemask.clear();
+  const int bits = 8 * sizeof(unsigned long);
+  for (int node : (nodes.empty() ? numa_nodes() : nodes)) {
+    if (node < 0) continue;
+    if (nodemask.size() <= (unsigned) (node / bits)) nodemask.resize(node / bits + 1, 0ul);
+    nodemask[node / bits] |= 1ul << (node % bits);
+  }
+}
+mem_policy get_mem_policy() {
+  return policy;
+}
+std::vector<int> get_mem_nodes() {
+  const int bits = 8 * sizeof(unsigned long);
+  std::vector<int> nodes;
+  for (int node = 0; node < bits * (int) nodemask.size(); ++node) {
+    if (nodemask[node / bits] & (1ul << (node % bits))) nodes.push_back(node);
+  }
+  return nodes;
+}
+
+const char* mem_policy_name(mem_policy p) {
+  switch (p) {
+    case mem_policy::local:      return "local";
+    case mem_policy::bind:       return "bind";
+    case mem_policy::interleave: return "interleave";
+  }
+  return "";
+}
+
+void set_page_policy(page_policy p) {
+  pages = p;
+}
+page_policy get_page_policy() {
+  return pages;
+}
+
+const char* page_policy_name(page_policy p) {
+  switch (p) {
+    case page_policy::system:  return "system";
+    case page_policy::small:   return "4k";
+    case page_policy::thp:     return "thp";
+    case page_policy::huge_2m: return "2m";
+    case page_policy::huge_1g: return "1g";
+  }
+  return "";
+}
+
+bool parse_page_policy(const char* s, page_policy& p) {
+  for (page_policy q : {page_policy::system, page_policy::small, page_policy::thp, page_policy::huge_2m, page_policy::huge_1g}) {
+    if (strcasecmp(s, page_policy_name(q)) == 0) {
+      p = q;
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifdef __linux__
+// whole pages contained in [ptr, ptr+n)
+static bool page_range(void* ptr, unsigned long long int n, unsigned long long int& first, unsigned long long int& last) {
+  const unsigned long long int page = sysconf(_SC_PAGESIZE);
+  first = (reinterpret_cast<unsigned long long int>(ptr) + page - 1) / page * page;
+  last = (reinterpret_cast<unsigned long long int>(ptr) + n) / page * page;
+  return first < last;
+}
+#endif
+
+static void place(void* ptr, unsigned long long int n) {
+#ifdef __linux__
+  if (policy == mem_policy::local || nodemask.empty()) return;
+  unsigned long long int first, last;
+  if (!page_range(ptr, n, first, last)) return;
+  int mode = policy == mem_policy::bind ? MPOL_BIND : MPOL_INTERLEAVE;
+  long err = syscall(SYS_mbind, first, last - first, mode, nodemask.data(), 8 * sizeof(unsigned long) * nodemask.size() + 1, MPOL_MF_MOVE);
+  if (err != 0) {
+    static bool warned = false;
+    if (!warned) {
+      std::ostringstream message;
+      message << "Warning: Failed to set the NUMA placement of the buffers (" << mem_policy_name(policy) << ")";
+      report(message);
+      warned = true;
+    }
+  }
+#else
+  (void) ptr;
+  (void) n;
+#endif
+}
+
+#ifdef __linux__
+// the mapping is a whole number of huge pages, its size is returned in "n"
+static void* allocate_hugetlb(unsigned long long int& n) {
+  const unsigned long long int page = pages == page_policy::huge_1g ? 1ull << 30 : 1ull << 21;
+  n = (n + page - 1) / page * page;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (pages == page_policy::huge_1g ? MAP_HUGE_1GB : MAP_HUGE_2MB);
+  void* ptr = mmap(nullptr, n, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (ptr == MAP_FAILED) {
+    std::ostringstream message;
+    message << "Error: Failed to allocate " << n << " bytes with " << page_policy_name(pages) << " pages (are enough huge pages reserved in /sys/kernel/mm/hugepages?)";
+    report(message);
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mappings_mutex);
+  mappings[ptr] = n;
+  return ptr;
+}
+#endif
 
 void* allocate(unsigned long long int n, unsigned long long int alignment) {
   void* ptr = nullptr;
   if (alignment < sizeof(void*)) alignment = sizeof(void*);
+#ifdef __linux__
+  if (pages == page_policy::huge_2m || pages == page_policy::huge_1g) {
+    // mbind() only accepts whole huge pages
+    unsigned long long int mapped = n;
+    ptr = allocate_hugetlb(mapped);
+    if (ptr) place(ptr, mapped);
+    if (ptr && cold_enabled) cold_track(ptr, n);
+    return ptr;
+  }
+  // transparent huge pages are only used for 2 MiB aligned ranges
+  if (pages == page_policy::thp && alignment < (1ull << 21)) alignment = 1ull << 21;
+#endif
   if (posix_memalign(&ptr, alignment, n) != 0) {
-    std::cerr << "Error: Failed to allocate " << n << " bytes (alignment: " << alignment << ")" << std::endl;
+    std::ostringstream message;
+    message << "Error: Failed to allocate " << n << " bytes (alignment: " << alignment << ")";
+    report(message);
     return nullptr;
   }
+#ifdef __linux__
+  if (pages != page_policy::system) {
+    unsigned long long int first, last;
+    if (page_range(ptr, n, first, last)) {
+      madvise(reinterpret_cast<void*>(first), last - first, pages == page_policy::thp ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+    }
+  }
+#endif
+  place(ptr, n);
+  if (cold_enabled) cold_track(ptr, n);
   return ptr;
 }
 void deallocate(void* ptr) {
+  if (cold_enabled) cold_untrack(ptr);
+#ifdef __linux__
+  {
+    std::lock_guard<std::mutex> lock(mappings_mutex);
+    auto it = mappings.find(ptr);
+    if (it != mappings.end()) {
+      munmap(ptr, it->second);
+      mappings.erase(it);
+      return;
+    }
+  }
+#endif
   free(ptr);
 }
@@ -1,50 +1,81 @@
-#include <iostream>
 #include "bandwidth.h"
+#include "bench.h"
 #include "stream.h"
-#include "omp-helper.h"
-
-#ifdef _OPENMP
-#include <omp.h>
-#endif
 
 namespace {
-  template <class F>
-  float64_t bench(F&& f, int repeat = 1, int tries = 1) noexcept {
-    using counter_t = Timer::counter_t;
-    using diff_t = Timer::diff_t;
-
-    static diff_t dmin = -1, dmax = 0;
-    OMP(master) {
-      dmin = -1;
-      dmax = 0;
-    }
-    for (int i = 0; i < tries; i++) {
-      Timer::reset();
-      OMP(barrier);
-      asm volatile ("");
-      counter_t t0 = Timer::read();
-      for (int j = 0; j < repeat; j++) {
-        asm volatile ("");
-        f();
-        asm volatile ("");
-      }
-      counter_t t1 = Timer::read();
-      asm volatile ("");
-      diff_t d = Timer::diff(t0, t1);
-      OMP(critical) {
-        dmax = (dmax < 0 || d > dmax) ? d : dmax;
-      }
-      OMP(barrier);
-      OMP(master) {
-        dmin = (dmin < 0 || dmax < dmin) ? dmax : dmin;
-        dmax = 0;
-      }
-    }
-    return static_cast<float64_t>(dmin) / (repeat * Timer::frequency);
+  // factor of scale and triad (3 for the integer types, so that the multiplication is not optimized out)
+  template <class T>
+  constexpr T scalar_value() noexcept {
+    return static_cast<T>(1.2345) != static_cast<T>(1) ? static_cast<T>(1.2345) : static_cast<T>(3);
+  }
+
+  // function table of the kernels of K
+  template <class K>
+  bandwidth table() noexcept {
+    bandwidth b;
+    b.kern = K::kern;
+    b.nontemporal = K::nontemporal;
+#ifdef F16_MEM_OPS
+    b.read_f16 = &K::read;
+    b.write_f16 = &K::write;
+    b.copy_f16 = &K::copy;
+#endif
+#if defined(F16_MEM_OPS) && defined(F16_ARI_OPS)
+    b.incr_f16 = &K::incr;
+    b.scale_f16 = &K::scale;
+    b.add_f16 = &K::add;
+    b.triad_f16 = &K::triad;
+#endif
+    b.read_f32 = &K::read;
+    b.write_f32 = &K::write;
+    b.copy_f32 = &K::copy;
+    b.incr_f32 = &K::incr;
+    b.scale_f32 = &K::scale;
+    b.add_f32 = &K::add;
+    b.triad_f32 = &K::triad;
+    b.read_f64 = &K::read;
+    b.write_f64 = &K::write;
+    b.copy_f64 = &K::copy;
+    b.incr_f64 = &K::incr;
+    b.scale_f64 = &K::scale;
+    b.add_f64 = &K::add;
+    b.triad_f64 = &K::triad;
+    b.read_i8 = &K::read;
+    b.write_i8 = &K::write;
+    b.copy_i8 = &K::copy;
+    b.incr_i8 = &K::incr;
+    b.scale_i8 = &K::scale;
+    b.add_i8 = &K::add;
+    b.triad_i8 = &K::triad;
+    b.read_i16 = &K::read;
+    b.write_i16 = &K::write;
+    b.copy_i16 = &K::copy;
+    b.incr_i16 = &K::incr;
+    b.scale_i16 = &K::scale;
+    b.add_i16 = &K::add;
+    b.triad_i16 = &K::triad;
+    b.read_i32 = &K::read;
+    b.write_i32 = &K::write;
+    b.copy_i32 = &K::copy;
+    b.incr_i32 = &K::incr;
+    b.scale_i32 = &K::scale;
+    b.add_i32 = &K::add;
+    b.triad_i32 = &K::triad;
+    b.read_i64 = &K::read;
+    b.write_i64 = &K::write;
+    b.copy_i64 = &K::copy;
+    b.incr_i64 = &K::incr;
+    b.scale_i64 = &K::scale;
+    b.add_i64 = &K::add;
+    b.triad_i64 = &K::triad;
+    return b;
   }
 
   template <int N, bool nt>
   struct Bandwidth {
+    constexpr static int kern = N;
+    constexpr static bool nontemporal = nt;
+
     template <class T>
     static float64_t read(const T*restrict A, long long n, int repeat = 1, int tries = 1) noexcept {
       if (n == 0) return 0.;
@@ -68,7 +99,7 @@ namespace {
     template <class T>
     static float64_t scale(const T*restrict A, T*restrict B, long long n, int repeat = 1, int tries = 1) noexcept {
       if (n == 0) return 0.;
-      T scalar = 1.2345;
+      T scalar = scalar_value<T>();
       return 2*sizeof(T) * n / bench([A, B, n, scalar]{ stream<N, nt>::scale(scalar, A, B, n); }, repeat, tries);
     }
     template <class T>
@@ -79,46 +110,200 @@ namespace {
     template <class T>
     static float64_t triad(const T*restrict A, const T*restrict B, T*restrict C, long long n, int repeat = 1, int tries = 1) noexcept {
       if (n == 0) return 0.;
-      T scalar = 1.2345;
+      T scalar = scalar_value<T>();
       return 3*sizeof(T) * n / bench([A, B, C, n, scalar]{ stream<N, nt>::triad(scalar, A, B, C, n); }, repeat, tries);
     }
 
+    template <class T>
+    static float64_t mix(const T*restrict A, T*restrict B, long long n, long long s, int k, int w, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return (k + w)*sizeof(T) * n / bench([A, B, n, s, k, w]{ stream<N, nt>::mix(A, B, n, s, k, w); }, repeat, tries);
+    }
+
+    static void pass_read(const float64_t*restrict A, long long n) noexcept {
+      stream<N, nt>::read(A, n);
+    }
+    static void pass_write(float64_t*restrict A, long long n) noexcept {
+      stream<N, nt>::write(A, n);
+    }
+    static void pass_copy(const float64_t*restrict A, float64_t*restrict B, long long n) noexcept {
+      stream<N, nt>::copy(A, B, n);
+    }
+    static void pass_triad(const float64_t*restrict A, const float64_t*restrict B, float64_t*restrict C, long long n) noexcept {
+      stream<N, nt>::triad(scalar_value<float64_t>(), A, B, C, n);
+    }
+
+    // only the plain stream kernels run the read/write mixes and the untimed passes
     operator bandwidth() const noexcept {
-      bandwidth b;
-      b.kern = N;
-      b.nontemporal = nt;
+      bandwidth b = table<Bandwidth>();
+#if defined(F16_MEM_OPS) && defined(F16_ARI_OPS)
+      b.mix_f16 = &mix;
+#endif
+      b.mix_f32 = &mix;
+      b.mix_f64 = &mix;
+      b.mix_i8 = &mix;
+      b.mix_i16 = &mix;
+      b.mix_i32 = &mix;
+      b.mix_i64 = &mix;
+      b.pass_read = &pass_read;
+      b.pass_write = &pass_write;
+      b.pass_copy = &pass_copy;
+      b.pass_triad = &pass_triad;
+      return b;
+    }
+  };
+
+  // temporal stores with software prefetches "d" elements ahead
+  template <int N, int hint>
+  struct Prefetch {
+    template <class T>
+    static float64_t read(const T*restrict A, long long n, long long d, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return sizeof(T) * n / bench([A, n, d]{ prefetch_stream<N, hint>::read(A, n, d); }, repeat, tries);
+    }
+    template <class T>
+    static float64_t write(T*restrict A, long long n, long long d, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return sizeof(T) * n / bench([A, n, d]{ prefetch_stream<N, hint>::write(A, n, d); }, repeat, tries);
+    }
+    template <class T>
+    static float64_t copy(const T*restrict A, T*restrict B, long long n, long long d, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return 2*sizeof(T) * n / bench([A, B, n, d]{ prefetch_stream<N, hint>::copy(A, B, n, d); }, repeat, tries);
+    }
+    template <class T>
+    static float64_t incr(T*restrict A, long long n, long long d, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return 2*sizeof(T) * n / bench([A, n, d]{ prefetch_stream<N, hint>::incr(A, n, d); }, repeat, tries);
+    }
+    template <class T>
+    static float64_t scale(const T*restrict A, T*restrict B, long long n, long long d, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      T scalar = scalar_value<T>();
+      return 2*sizeof(T) * n / bench([A, B, n, d, scalar]{ prefetch_stream<N, hint>::scale(scalar, A, B, n, d); }, repeat, tries);
+    }
+    template <class T>
+    static float64_t add(const T*restrict A, const T*restrict B, T*restrict C, long long n, long long d, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return 3*sizeof(T) * n / bench([A, B, C, n, d]{ prefetch_stream<N, hint>::add(A, B, C, n, d); }, repeat, tries);
+    }
+    template <class T>
+    static float64_t triad(const T*restrict A, const T*restrict B, T*restrict C, long long n, long long d, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      T scalar = scalar_value<T>();
+      return 3*sizeof(T) * n / bench([A, B, C, n, d, scalar]{ prefetch_stream<N, hint>::triad(scalar, A, B, C, n, d); }, repeat, tries);
+    }
+
+    operator prefetch_bandwidth() const noexcept {
+      prefetch_bandwidth p;
+      p.kern = N;
+      p.hint = hint;
 #ifdef F16_MEM_OPS
-      b.read_f16 = &read;
-      b.write_f16 = &write;
-      b.copy_f16 = &copy;
+      p.read_f16 = &read;
+      p.write_f16 = &write;
+      p.copy_f16 = &copy;
 #endif
 #if defined(F16_MEM_OPS) && defined(F16_ARI_OPS)
-      b.incr_f16 = &incr;
-      b.scale_f16 = &scale;
-      b.add_f16 = &add;
-      b.triad_f16 = &triad;
+      p.incr_f16 = &incr;
+      p.scale_f16 = &scale;
+      p.add_f16 = &add;
+      p.triad_f16 = &triad;
 #endif
-      b.read_f32 = &read;
-      b.write_f32 = &write;
-      b.copy_f32 = &copy;
-      b.incr_f32 = &incr;
-      b.scale_f32 = &scale;
-      b.add_f32 = &add;
-      b.triad_f32 = &triad;
-      b.read_f64 = &read;
-      b.write_f64 = &write;
-      b.copy_f64 = &copy;
-      b.incr_f64 = &incr;
-      b.scale_f64 = &scale;
-      b.add_f64 = &add;
-      b.triad_f64 = &triad;
-      return b;
+      p.read_f32 = &read;
+      p.write_f32 = &write;
+      p.copy_f32 = &copy;
+      p.incr_f32 = &incr;
+      p.scale_f32 = &scale;
+      p.add_f32 = &add;
+      p.triad_f32 = &triad;
+      p.read_f64 = &read;
+      p.write_f64 = &write;
+      p.copy_f64 = &copy;
+      p.incr_f64 = &incr;
+      p.scale_f64 = &scale;
+      p.add_f64 = &add;
+      p.triad_f64 = &triad;
+      p.read_i8 = &read;
+      p.write_i8 = &write;
+      p.copy_i8 = &copy;
+      p.incr_i8 = &incr;
+      p.scale_i8 = &scale;
+      p.add_i8 = &add;
+      p.triad_i8 = &triad;
+      p.read_i16 = &read;
+      p.write_i16 = &write;
+      p.copy_i16 = &copy;
+      p.incr_i16 = &incr;
+      p.scale_i16 = &scale;
+      p.add_i16 = &add;
+      p.triad_i16 = &triad;
+      p.read_i32 = &read;
+      p.write_i32 = &write;
+      p.copy_i32 = &copy;
+      p.incr_i32 = &incr;
+      p.scale_i32 = &scale;
+      p.add_i32 = &add;
+      p.triad_i32 = &triad;
+      p.read_i64 = &read;
+      p.write_i64 = &write;
+      p.copy_i64 = &copy;
+      p.incr_i64 = &incr;
+      p.scale_i64 = &scale;
+      p.add_i64 = &add;
+      p.triad_i64 = &triad;
+      return p;
+    }
+  };
+
+  // accesses through an index array: every op also reads the 32-bit indexes
+  template <int N>
+  struct Gather {
+    template <class T>
+    static float64_t gather(const T*restrict A, const int32_t*restrict idx, long long n, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return (sizeof(T) + sizeof(int32_t)) * n / bench([A, idx, n]{ indexed<N>::gather(A, idx, n); }, repeat, tries);
+    }
+    template <class T>
+    static float64_t scatter(T*restrict A, const int32_t*restrict idx, long long n, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return (sizeof(T) + sizeof(int32_t)) * n / bench([A, idx, n]{ indexed<N>::scatter(A, idx, n); }, repeat, tries);
+    }
+    template <class T>
+    static float64_t gather_add(const T*restrict A, const int32_t*restrict idx, const T*restrict B, T*restrict C, long long n, int repeat = 1, int tries = 1) noexcept {
+      if (n == 0) return 0.;
+      return (3*sizeof(T) + sizeof(int32_t)) * n / bench([A, idx, B, C, n]{ indexed<N>::gather_add(A, idx, B, C, n); }, repeat, tries);
+    }
+
+    operator gather_bandwidth() const noexcept {
+      gather_bandwidth g;
+      g.kern = N;
+      g.gather_f32 = &gather;
+      g.scatter_f32 = &scatter;
+      g.gather_add_f32 = &gather_add;
+      g.gather_f64 = &gather;
+      g.scatter_f64 = &scatter;
+      g.gather_add_f64 = &gather_add;
+      g.gather_i32 = &gather;
+      g.scatter_i32 = &scatter;
+      g.gather_add_i32 = &gather_add;
+      g.gather_i64 = &gather;
+      g.scatter_i64 = &scatter;
+      g.gather_add_i64 = &gather_add;
+      return g;
     }
   };
 }
 
 
-bandwidth bandwidth_benches[] = {
+#ifndef BANDWIDTH_ISA
+#define BANDWIDTH_ISA native
+#endif
+#define ISA_CAT_(a, b) a##b
+#define ISA_CAT(a, b) ISA_CAT_(a, b)
+#define ISA_STR_(x) #x
+#define ISA_STR(x) ISA_STR_(x)
+
+static bandwidth benches[] = {
   // Temporal stores
   Bandwidth<  1, false>{},
   Bandwidth<  2, false>{},
@@ -143,3 +328,45 @@ bandwidth bandwidth_benches[] = {
   Bandwidth<512, true>{},
   bandwidth{}
 };
+
+// software prefetches (64 elements per iteration: at least one cache line for every type)
+static prefetch_bandwidth prefetches[] = {
+  Prefetch<64, prefetch_t0>{},
+  Prefetch<64, prefetch_t1>{},
+  Prefetch<64, prefetch_t2>{},
+  Prefetch<64, prefetch_nta>{},
+  prefetch_bandwidth{}
+};
+
+static gather_bandwidth gathers[] = {
+  Gather< 1>{},
+  Gather< 2>{},
+  Gather< 4>{},
+  Gather< 8>{},
+  Gather<16>{},
+  Gather<32>{},
+  Gather<64>{},
+  gather_bandwidth{}
+};
+
+
+bandwidth_isa ISA_CAT(bandwidth_isa_, BANDWIDTH_ISA) = {
+  ISA_STR(BANDWIDTH_ISA),
+#if defined(__AVX512F__) || defined(__KNC__)
+  512, 32,
+#elif defined(__AVX__)
+  256, 16,
+#elif defined(__aarch64__)
+  128, 32,
+#else
+  128, 16,
+#endif
+#if defined(__SSE2__)
+  true,
+#else
+  false,
+#endif
+  benches,
+  prefetches,
+  gathers
+};
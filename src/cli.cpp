@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include "cli.h"
+#include "cold.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+/* OPTIONS */
+bool bytes_power_1024 = false;
+bool verbose = false;
+bool CSV = false;
+bool first = true;
+bool latency_mode = false;
+bool loaded_mode = false;
+load_op loaded_op = load_op::read;
+bool traffic_mode = false;
+float64_t traffic_rate = 0.;   // bytes per second over all the threads (0: unlimited)
+float64_t traffic_writes = 0.; // fraction of the bytes written
+float64_t traffic_duration = 0.; // seconds (0: until SIGINT or SIGTERM)
+bool numa_matrix = false;
+int current_cpu_node = -1, current_mem_node = -1;
+int max_threads = 1;
+std::vector<int> thread_counts;
+affinity pinning = affinity::none;
+std::vector<int> allowed_cpus;
+std::ofstream stats_file;
+long long chase_stride = 0;
+variant_filter filter;
+bool show_variants = false;
+std::vector<cache_level> caches;
+bool summary_only = false;
+bool summary_first = true;
+std::vector<bandwidth_type> types;
+std::vector<long long> prefetch_distances;
+std::vector<long long> strides;
+std::vector<index_pattern> patterns;
+// read:write mixes (arrays read, arrays written)
+std::vector<std::pair<int, int>> mixes;
+std::vector<int> stream_counts;
+bool memops_mode = false;
+std::vector<page_policy> page_policies;
+const char* coherence_cpus = nullptr;
+const char* monitor_probes = nullptr;
+float64_t monitor_interval = 3600.;
+std::string monitor_history = "bandwidth-history.csv";
+float64_t monitor_threshold = 0.1;
+std::string monitor_alert;
+long long stream_offset = 0; // bytes added to the start of every array after the first one (array j: j * offset)
+
+const char* op_names[nb_ops] = {"read", "write", "copy", "incr", "scale", "add", "triad"};
+
+const variant& fastest(const std::vector<variant>& variants) {
+  unsigned best = 0;
+  for (unsigned i = 1; i < variants.size(); ++i) {
+    if (variants[i].bandwidth > variants[best].bandwidth) best = i;
+  }
+  return variants[best];
+}
+
+const bandwidth* fastest_variant(bandwidth_op op, long long size, int threads, const variant_filter& variants) {
+  measure_options options;
+  options.variants = variants;
+  measure_result r = measure(op, bandwidth_type::f64, size, threads, options);
+  const bandwidth* first = nullptr;
+  for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
+    if (!selected(b, sizeof(float64_t), variants)) continue;
+    if (b->kern == r.kern && b->nontemporal == r.nontemporal) return b;
+    if (!first) first = b;
+  }
+  return first;
+}
+
+void print_stats(const char* type, float64_t size, int threads, const char* op, float64_t bandwidth, const std::vector<float64_t>& tries, const counts& events) {
+  if (!stats_file.is_open()) return;
+  stats st = compute_stats(tries);
+  stats_file << type << ',' << size << ',' << threads << ',' << op << ',' << bandwidth * st.min << ',' << st.count;
+  stats_file << ',' << st.min << ',' << st.median << ',' << st.mean << ',' << st.p95 << ',' << st.stddev << ',' << st.cv;
+  if (counters_enabled) {
+    for (int event = 0; event < nb_events; ++event) stats_file << ',' << events.value[event];
+  }
+  stats_file << '\n';
+}
+
+void set_num_threads(int k) {
+#ifdef _OPENMP
+  omp_set_num_threads(k);
+#else
+  (void) k;
+#endif
+}
+
+int get_num_threads() {
+#ifdef _OPENMP
+  int k = 0;
+  OMP(parallel) {
+    OMP(atomic) ++k;
+  }
+#else
+  int k = 1;
+#endif
+  return k;
+}
+
+std::vector<point> sweep(const std::vector<long long>& sizes) {
+  std::vector<point> points;
+  for (long long size : sizes) {
+    if (thread_counts.empty()) {
+      points.push_back({size, max_threads});
+    }
+    for (int threads : thread_counts) {
+      points.push_back({size, threads});
+    }
+  }
+  return points;
+}
+
+std::vector<int> pin_threads(int k) {
+  if (pinning == affinity::none) return {};
+  std::vector<int> cpus = affinity_cpus(pinning, k, allowed_cpus);
+  if (cpus.size() != (unsigned) k) return {};
+  bool pinned = true;
+  OMP(parallel) {
+#ifdef _OPENMP
+    int id = omp_get_thread_num();
+#else
+    int id = 0;
+#endif
+    if (!bind_thread({cpus[id]})) {
+      OMP(atomic write) pinned = false;
+    }
+  }
+  if (!pinned) {
+    std::cerr << "Warning: Failed to pin the threads on cpus " << format_list(cpus) << std::endl;
+  }
+  return cpus;
+}
+
+void bind_threads(const std::vector<int>& nodes) {
+  bool bound = true;
+  allowed_cpus.clear();
+  for (int node : nodes) {
+    std::vector<int> node_cpus = numa_node_cpus(node);
+    allowed_cpus.insert(allowed_cpus.end(), node_cpus.begin(), node_cpus.end());
+  }
+  set_num_threads(max_threads);
+  OMP(parallel) {
+    if (!bind_thread_to_nodes(nodes)) {
+      OMP(atomic write) bound = false;
+    }
+  }
+  if (!bound) {
+    std::cerr << "Warning: Failed to bind the threads to the cpu node(s)";
+    for (int node : nodes) std::cerr << ' ' << node;
+    std::cerr << std::endl;
+  }
+}
+void restore_threads(const std::vector<int>& cpus) {
+  allowed_cpus = cpus;
+  set_num_threads(max_threads);
+  OMP(parallel) {
+    bind_thread(cpus);
+  }
+}
+
+void* allocate_or_abort(long long size, long long alignment) {
+  void* buffer = allocate(size, alignment);
+  if (!buffer) allocation_failed();
+  return buffer;
+}
+void allocation_failed() {
+  std::cerr << "Error: Allocation failed. Aborting." << std::endl;
+  abort();
+}
+
+std::string mix_name(std::pair<int, int> mix) {
+  return "mix" + std::to_string(mix.first) + ":" + std::to_string(mix.second);
+}
+
+bool parse_types(const char* str, std::vector<bandwidth_type>& types) {
+  const bandwidth_type all[] = {bandwidth_type::f16, bandwidth_type::f32, bandwidth_type::f64,
+                                bandwidth_type::i8, bandwidth_type::i16, bandwidth_type::i32, bandwidth_type::i64};
+  types.clear();
+  while (*str) {
+    const char* end = std::strchr(str, ',');
+    std::string word = end ? std::string(str, end) : std::string(str);
+    bool found = false;
+    for (bandwidth_type type : all) {
+      bool family = word == "all" || (word == "float" && type <= bandwidth_type::f64) || (word == "int" && type >= bandwidth_type::i8);
+      if (word != type_name(type) && !family) continue;
+      found = true;
+      // f16 is only part of the families when it is compiled in
+      if (type_size(type) == 0) {
+        if (!family) {
+          std::cerr << "error: type \"" << word << "\" is not supported by this build\n";
+          return false;
+        }
+        continue;
+      }
+      if (std::find(types.begin(), types.end(), type) == types.end()) types.push_back(type);
+    }
+    if (!found) {
+      std::cerr << "error: unknown type \"" << word << "\"\n";
+      return false;
+    }
+    str = end ? end + 1 : str + word.size();
+  }
+  return !types.empty();
+}
+
+void print_config_header(const std::string& tries) {
+  if (numa_matrix) std::cout << ",cpu_node,mem_node";
+  if (get_page_policy() != page_policy::system) std::cout << ",pages";
+  if (!thread_counts.empty()) std::cout << ",threads";
+  if (adaptive.enabled) std::cout << tries;
+}
+void print_config_row(int threads, long long tries, bool with_tries) {
+  if (numa_matrix) std::cout << ',' << current_cpu_node << ',' << current_mem_node;
+  if (get_page_policy() != page_policy::system) std::cout << ',' << page_policy_name(get_page_policy());
+  if (!thread_counts.empty()) std::cout << ',' << threads;
+  if (with_tries && adaptive.enabled) std::cout << ',' << tries;
+}
+void print_config() {
+  const char* sep = " (";
+  if (current_cpu_node >= 0) {
+    std::cout << sep << "cpu node: " << current_cpu_node << ", memory node: " << current_mem_node;
+    sep = ", ";
+  }
+  if (get_page_policy() != page_policy::system) {
+    std::cout << sep << "pages: " << page_policy_name(get_page_policy());
+    sep = ", ";
+  }
+  if (cold_enabled) {
+    std::cout << sep << "cold caches: " << evict_method_name(cold_method());
+    sep = ", ";
+  }
+  if (sep[0] == ',') std::cout << ")";
+}
+
+void print_header(const std::string& columns, const std::string& title, const std::string& tries) {
+  if (CSV) {
+    if (!first) return;
+    std::cout << columns;
+    print_config_header(tries);
+    std::cout << std::endl;
+    first = false;
+  } else {
+    std::cout << title;
+    print_config();
+    std::cout << std::endl;
+  }
+}
+void print_point(float64_t size, int threads, int repeat, int tries, const std::vector<int>& cpus, const std::string& details) {
+  std::cout << "  size: "     << std::setw(6) << bytes(size) << details;
+  if (!thread_counts.empty()) {
+    std::cout << "  threads: " << std::setw(3) << threads;
+  }
+  if (verbose) {
+    std::cout << "  repeat: " << std::setw(4) << repeat;
+    if (!adaptive.enabled) std::cout << "  tries: "  << std::setw(4) << tries;
+    if (!cpus.empty()) std::cout << "  cpus: " << format_list(cpus);
+  }
+}
+
+long long cache_capacity(const cache_level& c, int threads) {
+  return c.size * std::min(threads, c.instances);
+}
+
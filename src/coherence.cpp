@@ -0,0 +1,143 @@
+#include <thread>
+#include "allocation.h"
+#include "coherence.h"
+#include "placement.h"
+#include "timer.h"
+
+namespace {
+  // every flag has a cache line of its own
+  struct alignas(64) flag {
+    long long value;
+  };
+
+  inline void relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    asm volatile ("pause" ::: "memory");
+#elif defined(__aarch64__)
+    asm volatile ("yield" ::: "memory");
+#else
+    asm volatile ("" ::: "memory");
+#endif
+  }
+
+  inline void wait_for(const flag& f, long long value) noexcept {
+    while (__atomic_load_n(&f.value, __ATOMIC_ACQUIRE) != value) relax();
+  }
+
+  // runs a() on cpu_a and b() on cpu_b, in two new threads (the affinity of the calling thread is kept)
+  template <class A, class B>
+  bool run_pair(int cpu_a, int cpu_b, A&& a, B&& b) noexcept {
+    bool bound_a = false, bound_b = false;
+    // b() waits for a() (and would spin forever without it): it only starts once the thread of a() exists
+    // (1: go, -1: the thread of a() could not be created)
+    int start = 0;
+    std::thread tb;
+    try {
+      tb = std::thread([&]{
+        bound_b = bind_thread({cpu_b});
+        int s;
+        while ((s = __atomic_load_n(&start, __ATOMIC_ACQUIRE)) == 0) relax();
+        if (s > 0) b();
+      });
+    } catch (...) {
+      return false;
+    }
+    try {
+      std::thread ta([&]{
+        bound_a = bind_thread({cpu_a});
+        a();
+      });
+      __atomic_store_n(&start, 1, __ATOMIC_RELEASE);
+      ta.join();
+    } catch (...) {
+      __atomic_store_n(&start, -1, __ATOMIC_RELEASE);
+      tb.join();
+      return false;
+    }
+    tb.join();
+    return bound_a && bound_b;
+  }
+}
+
+float64_t pingpong_latency(int cpu_a, int cpu_b, long long rounds, int tries) noexcept {
+  if (rounds < 1) return 0.;
+  flag* f = allocate<flag>(1, sizeof(flag));
+  if (!f) return 0.;
+  f->value = 0;
+  Timer::diff_t best = -1;
+  // the first try is a warm-up: it includes the start of the other thread
+  const long long total = rounds * (tries + 1);
+  bool ok = run_pair(cpu_a, cpu_b, [f, rounds, tries, &best]{
+    long long v = 0;
+    for (int t = 0; t <= tries; ++t) {
+      Timer::counter_t t0 = Timer::read();
+      for (long long r = 0; r < rounds; ++r) {
+        __atomic_store_n(&f->value, ++v, __ATOMIC_RELEASE);
+        wait_for(*f, ++v);
+      }
+      Timer::counter_t t1 = Timer::read_end();
+      Timer::diff_t d = Timer::diff(t0, t1);
+      if (t > 0 && (best < 0 || d < best)) best = d;
+    }
+  }, [f, total]{
+    for (long long v = 1; v < 2 * total; v += 2) {
+      wait_for(*f, v);
+      __atomic_store_n(&f->value, v + 1, __ATOMIC_RELEASE);
+    }
+  });
+  deallocate(f);
+  if (!ok || best < 0) return 0.;
+  return static_cast<float64_t>(best) / (2 * rounds * Timer::frequency);
+}
+
+float64_t transfer_bandwidth(int cpu_a, int cpu_b, long long bytes, int tries) noexcept {
+  const long long words = coherence_block / sizeof(long long);
+  const long long blocks = bytes / coherence_block;
+  if (blocks < 2 || tries < 1) return 0.;
+  long long* ring = allocate<long long>(words * coherence_slots, 0x1000);
+  flag* flags = allocate<flag>(coherence_slots, sizeof(flag));
+  if (!ring || !flags) {
+    if (ring) deallocate(ring);
+    if (flags) deallocate(flags);
+    return 0.;
+  }
+  for (long long i = 0; i < words * coherence_slots; ++i) ring[i] = 0;
+  // the flag of a slot counts its writes and reads: even when the slot is free, odd when it is full
+  for (int s = 0; s < coherence_slots; ++s) flags[s].value = 0;
+  Timer::diff_t best = -1;
+  const long long total = blocks * tries;
+  bool ok = run_pair(cpu_a, cpu_b, [ring, flags, words, total]{
+    for (long long i = 0; i < total; ++i) {
+      const int s = i % coherence_slots;
+      const long long round = i / coherence_slots;
+      wait_for(flags[s], 2 * round);
+      long long* block = ring + s * words;
+      for (long long w = 0; w < words; ++w) block[w] = i + w;
+      __atomic_store_n(&flags[s].value, 2 * round + 1, __ATOMIC_RELEASE);
+    }
+  }, [ring, flags, words, blocks, tries, &best]{
+    long long sum = 0;
+    for (int t = 0; t < tries; ++t) {
+      Timer::counter_t t0 = 0;
+      for (long long b = 0; b < blocks; ++b) {
+        const long long i = t * blocks + b;
+        const int s = i % coherence_slots;
+        const long long round = i / coherence_slots;
+        wait_for(flags[s], 2 * round + 1);
+        // timed from the arrival of the first block: the time to fill the ring is not counted
+        if (b == 0) t0 = Timer::read();
+        const long long* block = ring + s * words;
+        for (long long w = 0; w < words; ++w) sum += block[w];
+        __atomic_store_n(&flags[s].value, 2 * round + 2, __ATOMIC_RELEASE);
+      }
+      Timer::counter_t t1 = Timer::read_end();
+      Timer::diff_t d = Timer::diff(t0, t1);
+      if (best < 0 || d < best) best = d;
+    }
+    asm volatile ("" :: "r"(sum));
+  });
+  deallocate(ring);
+  deallocate(flags);
+  if (!ok || best < 0) return 0.;
+  return (blocks - 1) * coherence_block * Timer::frequency / best;
+}
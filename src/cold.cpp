@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "allocation.h"
+#include "cold.h"
+#include "placement.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define HAS_CLFLUSH
+#endif
+
+bool cold_enabled = false;
+
+static evict_method method = evict_method::buffer;
+static const char* eviction_buffer = nullptr;
+static unsigned long long eviction_size = 0;
+
+// buffers tracked, with the thread that allocated them
+struct region {
+  const char* ptr;
+  unsigned long long n;
+  int owner;
+};
+static std::mutex regions_mutex;
+static std::vector<region> regions;
+static int next_owner = 0;
+static thread_local int owner = -1;
+
+static int current_owner() noexcept {
+  if (owner < 0) owner = __atomic_fetch_add(&next_owner, 1, __ATOMIC_RELAXED);
+  return owner;
+}
+
+const char* evict_method_name(evict_method m) {
+  switch (m) {
+    case evict_method::clflushopt: return "clflushopt";
+    case evict_method::clflush:    return "clflush";
+    case evict_method::dc_civac:   return "dc civac";
+    case evict_method::buffer:     return "buffer";
+  }
+  return "";
+}
+
+bool cold_init() {
+#if defined(HAS_CLFLUSH)
+  unsigned int eax, ebx, ecx, edx;
+  method = (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_CLFLUSHOPT)) ? evict_method::clflushopt : evict_method::clflush;
+  return true;
+#elif defined(__aarch64__)
+  method = evict_method::dc_civac;
+  return true;
+#else
+  method = evict_method::buffer;
+  long long largest = 32ll << 20;
+  for (const cache_level& c : cache_levels()) {
+    largest = std::max(largest, c.size);
+  }
+  eviction_size = 2 * largest;
+  eviction_buffer = static_cast<const char*>(allocate(eviction_size, 0x1000));
+  if (!eviction_buffer) return false;
+  std::fill(const_cast<char*>(eviction_buffer), const_cast<char*>(eviction_buffer) + eviction_size, 1);
+  return true;
+#endif
+}
+
+evict_method cold_method() noexcept {
+  return method;
+}
+
+void cold_track(const void* ptr, unsigned long long n) noexcept {
+  if (!ptr || n == 0) return;
+  std::lock_guard<std::mutex> lock(regions_mutex);
+  try {
+    regions.push_back({static_cast<const char*>(ptr), n, current_owner()});
+  } catch (...) {
+  }
+}
+
+void cold_untrack(const void* ptr) noexcept {
+  std::lock_guard<std::mutex> lock(regions_mutex);
+  regions.erase(std::remove_if(regions.begin(), regions.end(), [ptr](const region& r){ return r.ptr == ptr; }), regions.end());
+}
+
+#ifdef HAS_CLFLUSH
+__attribute__((target("clflushopt")))
+static void flush_opt(const char* p, unsigned long long n) noexcept {
+  for (unsigned long long i = 0; i < n; i += 64) {
+    _mm_clflushopt(const_cast<char*>(p + i));
+  }
+  _mm_clflushopt(const_cast<char*>(p + n - 1));
+}
+#endif
+
+static void flush(const char* p, unsigned long long n) noexcept {
+#if defined(HAS_CLFLUSH)
+  if (method == evict_method::clflushopt) {
+    flush_opt(p, n);
+    return;
+  }
+  for (unsigned long long i = 0; i < n; i += 64) {
+    _mm_clflush(p + i);
+  }
+  _mm_clflush(p + n - 1);
+#elif defined(__aarch64__)
+  unsigned long long ctr;
+  asm volatile ("mrs %0, ctr_el0" : "=r"(ctr));
+  const unsigned long long line = 4ull << ((ctr >> 16) & 0xf);
+  for (unsigned long long i = 0; i < n; i += line) {
+    asm volatile ("dc civac, %0" :: "r"(p + i) : "memory");
+  }
+  asm volatile ("dc civac, %0" :: "r"(p + n - 1) : "memory");
+#else
+  (void) p;
+  (void) n;
+#endif
+}
+
+void cold_evict() noexcept {
+  if (method == evict_method::buffer) {
+    if (!eviction_buffer) return;
+    // the loads evict the buffers of every thread (the writes of the dirty lines included)
+    unsigned long long sum = 0;
+    for (unsigned long long i = 0; i < eviction_size; i += 64) {
+      sum += eviction_buffer[i];
+    }
+    asm volatile ("" :: "r"(sum));
+    return;
+  }
+  // only the calling thread deallocates its buffers: they can be flushed outside of the lock
+  static thread_local std::vector<region> own;
+  const int self = current_owner();
+  own.clear();
+  {
+    std::lock_guard<std::mutex> lock(regions_mutex);
+    try {
+      for (const region& r : regions) {
+        if (r.owner == self) own.push_back(r);
+      }
+    } catch (...) {
+    }
+  }
+  for (const region& r : own) {
+    flush(r.ptr, r.n);
+  }
+#if defined(HAS_CLFLUSH)
+  _mm_mfence();
+#elif defined(__aarch64__)
+  asm volatile ("dsb ish" ::: "memory");
+#endif
+}
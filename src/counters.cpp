@@ -0,0 +1,281 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <dirent.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "counters.h"
+#include "placement.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#define HAS_PERF_EVENT
+#endif
+
+bool counters_enabled = false;
+
+const char* event_name(int event) {
+  switch (event) {
+    case ev_cycles:       return "cycles";
+    case ev_instructions: return "instructions";
+    case ev_l1d_misses:   return "l1d_misses";
+    case ev_llc_misses:   return "llc_misses";
+    case ev_dtlb_misses:  return "dtlb_misses";
+    case ev_dram_reads:   return "dram_reads";
+    case ev_dram_writes:  return "dram_writes";
+  }
+  return "";
+}
+
+// sums over the threads of the current try, and the ones of the fastest try since counters_reset()
+static unsigned long long totals[nb_events];
+static unsigned long long fastest[nb_events];
+static long long passes = 0;
+static bool available[nb_events];
+
+static void end_try(int repeat, bool keep) noexcept {
+  for (int event = 0; event < nb_events; ++event) {
+    if (keep) fastest[event] = totals[event];
+    totals[event] = 0;
+  }
+  if (keep) passes = repeat;
+}
+
+#ifdef HAS_PERF_EVENT
+static int perf_event_open(perf_event_attr& attr, pid_t pid, int cpu, int group) noexcept {
+  return syscall(__NR_perf_event_open, &attr, pid, cpu, group, 0);
+}
+
+// per-thread group of core events (the first one opened is the leader)
+struct core_group {
+  bool opened = false;
+  int leader = -1;
+  int n = 0;
+  int index[nb_events] = {};
+};
+static thread_local core_group group;
+// the events of the groups of every thread, closed by counters_fini()
+static std::mutex core_fds_mutex;
+static std::vector<int> core_fds;
+static bool closed = false;
+
+static bool core_attr(int event, perf_event_attr& attr) noexcept {
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  switch (event) {
+    case ev_cycles:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      return true;
+    case ev_instructions:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      return true;
+    case ev_l1d_misses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      return true;
+    case ev_llc_misses:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      return true;
+    case ev_dtlb_misses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      return true;
+  }
+  return false;
+}
+
+static void open_group() noexcept {
+  group.opened = true;
+  std::lock_guard<std::mutex> lock(core_fds_mutex);
+  if (closed) return;
+  for (int event = 0; event < nb_events; ++event) {
+    perf_event_attr attr;
+    group.index[event] = -1;
+    if (!core_attr(event, attr)) continue;
+    attr.disabled = group.leader < 0;
+    int fd = perf_event_open(attr, 0, -1, group.leader);
+    if (fd < 0) continue;
+    try {
+      core_fds.push_back(fd);
+    } catch (...) {
+      close(fd);
+      continue;
+    }
+    if (group.leader < 0) group.leader = fd;
+    group.index[event] = group.n++;
+    __atomic_store_n(&available[event], true, __ATOMIC_RELAXED);
+  }
+}
+
+// system wide uncore memory controller events, one per controller and socket
+struct uncore_event {
+  int fd;
+  int event;
+};
+static std::vector<uncore_event> uncore;
+
+static std::string read_line(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  if (file) std::getline(file, line);
+  return line;
+}
+
+// encodes an event description like "event=0x04,umask=0x03" with the "format" of the PMU
+static bool parse_config(const std::string& pmu, const std::string& spec, unsigned long long& config) {
+  config = 0;
+  std::string::size_type p = 0;
+  while (p < spec.size()) {
+    std::string::size_type end = spec.find(',', p);
+    if (end == std::string::npos) end = spec.size();
+    std::string term = spec.substr(p, end - p), field = term;
+    unsigned long long value = 1;
+    std::string::size_type eq = term.find('=');
+    if (eq != std::string::npos) {
+      field = term.substr(0, eq);
+      value = std::strtoull(term.c_str() + eq + 1, nullptr, 0);
+    }
+    // eg: "config:8-15"
+    std::string format = read_line(pmu + "/format/" + field);
+    if (format.compare(0, 7, "config:") != 0) return false;
+    int lo = std::atoi(format.c_str() + 7);
+    config |= value << lo;
+    p = end + 1;
+  }
+  return true;
+}
+
+static void open_uncore() {
+  const std::string root = "/sys/bus/event_source/devices/";
+  DIR* dir = opendir(root.c_str());
+  if (!dir) return;
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, 10, "uncore_imc") != 0) continue;
+    std::string pmu = root + name;
+    int type = std::atoi(read_line(pmu + "/type").c_str());
+    std::vector<int> cpus = parse_list(read_line(pmu + "/cpumask").c_str());
+    if (cpus.empty()) cpus.push_back(0);
+    const std::pair<int, const char*> events[] = {{ev_dram_reads, "cas_count_read"}, {ev_dram_writes, "cas_count_write"}};
+    for (const auto& ev : events) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = type;
+      attr.disabled = 1;
+      if (!parse_config(pmu, read_line(pmu + "/events/" + ev.second), attr.config)) continue;
+      for (int cpu : cpus) {
+        int fd = perf_event_open(attr, -1, cpu, -1);
+        if (fd < 0) continue;
+        uncore.push_back({fd, ev.first});
+        available[ev.first] = true;
+      }
+    }
+  }
+  closedir(dir);
+}
+
+bool counters_init() noexcept {
+  try {
+    open_uncore();
+  } catch (...) {
+  }
+  open_group();
+  for (int event = 0; event < nb_events; ++event) {
+    if (available[event]) return true;
+  }
+  return false;
+}
+
+void counters_fini() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(core_fds_mutex);
+    for (int fd : core_fds) close(fd);
+    core_fds.clear();
+    closed = true;
+  }
+  for (const uncore_event& u : uncore) close(u.fd);
+  uncore.clear();
+  counters_enabled = false;
+}
+
+void counters_start() noexcept {
+  if (!group.opened) open_group();
+  if (group.leader >= 0) {
+    ioctl(group.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void counters_stop() noexcept {
+  if (group.leader < 0) return;
+  ioctl(group.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  // { nr, values[nr] }
+  unsigned long long values[1 + nb_events];
+  if (read(group.leader, values, sizeof(values)) > 0) {
+    for (int event = 0; event < nb_events; ++event) {
+      if (group.index[event] >= 0) __atomic_fetch_add(&totals[event], values[1 + group.index[event]], __ATOMIC_RELAXED);
+    }
+  }
+}
+
+void counters_system_start() noexcept {
+  for (const uncore_event& u : uncore) {
+    ioctl(u.fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(u.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void counters_system_stop(int repeat, bool fastest_try) noexcept {
+  for (const uncore_event& u : uncore) {
+    ioctl(u.fd, PERF_EVENT_IOC_DISABLE, 0);
+    unsigned long long value;
+    if (read(u.fd, &value, sizeof(value)) == sizeof(value)) totals[u.event] += value;
+  }
+  end_try(repeat, fastest_try);
+}
+
+#else // HAS_PERF_EVENT
+
+bool counters_init() noexcept {
+  return false;
+}
+void counters_fini() noexcept {}
+void counters_start() noexcept {}
+void counters_stop() noexcept {}
+void counters_system_start() noexcept {}
+void counters_system_stop(int repeat, bool fastest_try) noexcept {
+  end_try(repeat, fastest_try);
+}
+
+#endif // HAS_PERF_EVENT
+
+void counters_reset() noexcept {
+  for (int event = 0; event < nb_events; ++event) {
+    totals[event] = 0;
+    fastest[event] = 0;
+  }
+  passes = 0;
+}
+
+counts counters_read() noexcept {
+  counts c;
+  for (int event = 0; event < nb_events; ++event) {
+    c.value[event] = (available[event] && passes > 0) ? static_cast<float64_t>(fastest[event]) / passes : -1.;
+  }
+  return c;
+}
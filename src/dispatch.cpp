@@ -0,0 +1,70 @@
+#include <cstring>
+#include "bandwidth.h"
+
+#ifdef BANDWIDTH_ISA_avx512
+extern bandwidth_isa bandwidth_isa_avx512;
+#endif
+#ifdef BANDWIDTH_ISA_avx2
+extern bandwidth_isa bandwidth_isa_avx2;
+#endif
+#ifdef BANDWIDTH_ISA_sse2
+extern bandwidth_isa bandwidth_isa_sse2;
+#endif
+#if !defined(BANDWIDTH_ISA_avx512) && !defined(BANDWIDTH_ISA_avx2) && !defined(BANDWIDTH_ISA_sse2)
+#ifndef BANDWIDTH_ISA_native
+#define BANDWIDTH_ISA_native
+#endif
+extern bandwidth_isa bandwidth_isa_native;
+#endif
+
+const bandwidth_isa* const bandwidth_isas[] = {
+#ifdef BANDWIDTH_ISA_avx512
+  &bandwidth_isa_avx512,
+#endif
+#ifdef BANDWIDTH_ISA_avx2
+  &bandwidth_isa_avx2,
+#endif
+#ifdef BANDWIDTH_ISA_sse2
+  &bandwidth_isa_sse2,
+#endif
+#ifdef BANDWIDTH_ISA_native
+  &bandwidth_isa_native,
+#endif
+  nullptr
+};
+
+bandwidth* bandwidth_benches = nullptr;
+prefetch_bandwidth* prefetch_benches = nullptr;
+gather_bandwidth* gather_benches = nullptr;
+const bandwidth_isa* current_isa = nullptr;
+
+bool isa_supported(const bandwidth_isa* isa) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (std::strcmp(isa->name, "avx512") == 0) {
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
+  if (std::strcmp(isa->name, "avx2") == 0) {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
+  if (std::strcmp(isa->name, "sse2") == 0) {
+    return __builtin_cpu_supports("sse2");
+  }
+#endif
+  // compiled for the build machine
+  (void) isa;
+  return true;
+}
+
+bool select_isa(const char* name) noexcept {
+  for (const bandwidth_isa* const* isa = bandwidth_isas; *isa; ++isa) {
+    if (name && std::strcmp(name, (*isa)->name) != 0) continue;
+    if (!isa_supported(*isa)) continue;
+    current_isa = *isa;
+    bandwidth_benches = (*isa)->benches;
+    prefetch_benches = (*isa)->prefetches;
+    gather_benches = (*isa)->gathers;
+    return true;
+  }
+  return false;
+}
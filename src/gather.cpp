@@ -0,0 +1,38 @@
+#include <algorithm>
+#include <random>
+#include "gather.h"
+
+const char* pattern_name(index_pattern pattern) {
+  switch (pattern) {
+    case index_pattern::random:    return "random";
+    case index_pattern::sorted:    return "sorted";
+    case index_pattern::clustered: return "clustered";
+  }
+  return "";
+}
+
+bool make_indexes(int32_t* idx, long long n, long long m, index_pattern pattern) noexcept {
+  if (m < 1 || m > 0x7fffffffLL) return false;
+  std::mt19937_64 rng(reinterpret_cast<unsigned long long>(idx));
+  std::uniform_int_distribution<long long> uniform(0, m-1);
+
+  switch (pattern) {
+    case index_pattern::random:
+      for (long long i = 0; i < n; ++i) idx[i] = uniform(rng);
+      break;
+    case index_pattern::sorted:
+      for (long long i = 0; i < n; ++i) idx[i] = uniform(rng);
+      std::sort(idx, idx + n);
+      break;
+    case index_pattern::clustered: {
+      long long span = std::min<long long>(cluster_span, m);
+      std::uniform_int_distribution<long long> start(0, m - span), offset(0, span-1);
+      for (long long i = 0; i < n; i += cluster_size) {
+        long long s = start(rng);
+        for (long long j = i; j < std::min<long long>(i + cluster_size, n); ++j) idx[j] = s + offset(rng);
+      }
+      break;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,29 @@
+#include <random>
+#include <utility>
+#include "latency.h"
+#include "bench.h"
+#include "stream.h"
+
+void* make_chain(void* buffer, long long size, long long stride) noexcept {
+  char* base = static_cast<char*>(buffer);
+  long long n = size / stride;
+  if (n < 1) return nullptr;
+
+  // every link first points to itself
+  for (long long i = 0; i < n; ++i) {
+    *reinterpret_cast<void**>(base + i * stride) = base + i * stride;
+  }
+  // Sattolo's shuffle: the links form a single cycle going through every line
+  std::mt19937_64 rng(reinterpret_cast<unsigned long long>(buffer));
+  for (long long i = n-1; i > 0; --i) {
+    long long j = std::uniform_int_distribution<long long>(0, i-1)(rng);
+    std::swap(*reinterpret_cast<void**>(base + i * stride), *reinterpret_cast<void**>(base + j * stride));
+  }
+  return base;
+}
+
+float64_t latency(void* chain, long long n, int repeat, int tries) noexcept {
+  if (n == 0 || chain == nullptr) return 0.;
+  void* p = chain;
+  return bench([&p, n]{ p = chase::walk(p, n); asm volatile ("" : "+r"(p)); }, repeat, tries) / n;
+}
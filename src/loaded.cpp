@@ -0,0 +1,124 @@
+#include <time.h>
+#include "loaded.h"
+#include "stream.h"
+#include "timer.h"
+
+namespace {
+  // elements per array and chunk (the intensity is adjusted after every chunk), a multiple of every kernel width
+  constexpr long long chunk = 0x10000 / sizeof(float64_t);
+
+  int arrays(load_op op) noexcept {
+    switch (op) {
+      case load_op::read:  return 1;
+      case load_op::copy:  return 2;
+      case load_op::triad: return 3;
+    }
+    return 1;
+  }
+
+  void run(load_op op, const bandwidth* b, float64_t* A, float64_t* B, float64_t* C, long long n) noexcept {
+    switch (op) {
+      case load_op::read:  b->pass_read(A, n); break;
+      case load_op::copy:  b->pass_copy(A, B, n); break;
+      case load_op::triad: b->pass_triad(A, B, C, n); break;
+    }
+  }
+}
+
+const char* load_op_name(load_op op) {
+  switch (op) {
+    case load_op::read:  return "read";
+    case load_op::copy:  return "copy";
+    case load_op::triad: return "triad";
+  }
+  return "";
+}
+
+float64_t generate_load(load_op op, const bandwidth* b, void* buffer, long long size, float64_t intensity, const bool* stop) noexcept {
+  // one array per operand, of m elements each
+  const int a = arrays(op);
+  const long long m = size / a / sizeof(float64_t) / b->kern * b->kern;
+  if (m < 1) return 0.;
+  float64_t* A = static_cast<float64_t*>(buffer);
+  float64_t* B = A + m;
+  float64_t* C = B + m;
+
+  long long moved = 0, i = 0;
+  Timer::counter_t start = Timer::read();
+  while (!__atomic_load_n(stop, __ATOMIC_RELAXED)) {
+    if (intensity <= 0.) {
+      // idle: the thread sleeps rather than spinning on its core
+      timespec t = {0, 1000000};
+      nanosleep(&t, nullptr);
+      continue;
+    }
+    long long n = m - i < chunk ? m - i : chunk;
+    Timer::counter_t t0 = Timer::read();
+    run(op, b, A + i, B + i, C + i, n);
+    Timer::counter_t t1 = Timer::read();
+    moved += a * n * sizeof(float64_t);
+    i = i + n < m ? i + n : 0;
+    if (intensity < 1.) {
+      // idle for (1/intensity - 1) times the duration of the chunk
+      Timer::counter_t until = t1 + static_cast<Timer::counter_t>((t1 - t0) * (1. / intensity - 1.));
+      while (Timer::read() < until && !__atomic_load_n(stop, __ATOMIC_RELAXED)) {}
+    }
+  }
+  Timer::counter_t end = Timer::read();
+  return moved * Timer::frequency / Timer::diff(start, end);
+}
+
+void generate_traffic(const bandwidth* reader, const bandwidth* writer, void* buffer, long long size, float64_t rate, float64_t writes,
+                      const bool* stop, unsigned long long* read, unsigned long long* written) noexcept {
+  // the widths are powers of two: a multiple of the larger one is a multiple of both
+  const int kern = reader->kern > writer->kern ? reader->kern : writer->kern;
+  const long long m = size / sizeof(float64_t) / kern * kern;
+  if (m < 1) return;
+  float64_t* A = static_cast<float64_t*>(buffer);
+
+  // the chunks are read or written so that the written fraction stays close to "writes"
+  unsigned long long r = 0, w = 0;
+  long long i = 0;
+  const Timer::counter_t start = Timer::read();
+  while (!__atomic_load_n(stop, __ATOMIC_RELAXED)) {
+    long long n = m - i < chunk ? m - i : chunk;
+    unsigned long long b = n * sizeof(float64_t);
+    if (w < writes * (r + w + b)) {
+      writer->pass_write(A + i, n);
+      w += b;
+      __atomic_fetch_add(written, b, __ATOMIC_RELAXED);
+    } else {
+      reader->pass_read(A + i, n);
+      r += b;
+      __atomic_fetch_add(read, b, __ATOMIC_RELAXED);
+    }
+    i = i + n < m ? i + n : 0;
+    if (rate > 0.) {
+      // waits until the bytes moved so far match the rate (sleeps through the long waits, so that
+      // the idle threads leave their cores to the other processes)
+      Timer::counter_t until = start + static_cast<Timer::counter_t>((r + w) / rate * Timer::frequency);
+      Timer::counter_t now = Timer::read();
+      if (now < until && (until - now) > 2e-3 * Timer::frequency) {
+        float64_t s = (until - now) / Timer::frequency - 1e-3;
+        timespec t = {static_cast<time_t>(s), static_cast<long>((s - static_cast<time_t>(s)) * 1e9)};
+        nanosleep(&t, nullptr);
+      }
+      while (Timer::read() < until && !__atomic_load_n(stop, __ATOMIC_RELAXED)) {}
+    }
+  }
+}
+
+float64_t chase_latency(void* chain, long long n, int tries) noexcept {
+  if (n == 0 || chain == nullptr) return 0.;
+  void* p = chain;
+  Timer::diff_t dmin = -1;
+  for (int i = 0; i < tries; ++i) {
+    Timer::counter_t t0 = Timer::read();
+    p = chase::walk(p, n);
+    asm volatile ("" : "+r"(p));
+    Timer::counter_t t1 = Timer::read_end();
+    Timer::diff_t d = Timer::diff(t0, t1);
+    dmin = (dmin < 0 || d < dmin) ? d : dmin;
+  }
+  return static_cast<float64_t>(dmin) / (n * Timer::frequency);
+}
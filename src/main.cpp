@@ -1,12 +1,24 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <vector>
 #include <algorithm>
+#include <sstream>
+#include <string>
 #include "allocation.h"
 #include "bandwidth.h"
+#include "cli.h"
+#include "cold.h"
+#include "counters.h"
+#include "measure.h"
+#include "modes.h"
+#include "monitor.h"
 #include "omp-helper.h"
+#include "placement.h"
+#include "stats.h"
+#include "timer.h"
 #include "types.h"
 
 #define OPTPARSE_API static
@@ -17,286 +29,87 @@
 #include "omp.h"
 #endif
 
-/* GLOBALS */
-bool bytes_power_1024 = false;
-bool verbose = false;
-bool CSV = false;
-bool first = true;
-#if !defined(__SSE2__)
-bool temporal = true;
-#else
-bool temporal = false;
-#endif
-
-template <class T>
-constexpr const char* name() noexcept {
-  return __PRETTY_FUNCTION__;
+// parses a relative precision: either a fraction (eg: 0.01) or a percentage (eg: 1%)
+float64_t parse_precision(const char* str) {
+  char* end;
+  float64_t x = std::strtod(str, &end);
+  if (*end == '%') x /= 100.;
+  return x;
 }
-#ifdef F16
-template <> constexpr const char* name<float16_t>() noexcept { return "f16"; }
-#endif
-template <> constexpr const char* name<float32_t>() noexcept { return "f32"; }
-template <> constexpr const char* name<float64_t>() noexcept { return "f64"; }
-
-struct bytes {
-  float64_t n = 0;
-  bytes() = default;
-  bytes(float64_t n) : n(n) {}
-  bytes(const char* s) {
-    char* p = nullptr;
-    n = std::strtod(s, &p);
-    if (!p) return;
-    while (*p == ' ') ++p;
-    float64_t power = 1000.;
-    if (*p != 0 && p[1] == 'i') power = 1024.;
-    switch (*p) {
-      case 'f':
-        n /= power;
-        [[fallthrough]];
-      case 'p':
-        n /= power;
-        [[fallthrough]];
-      case 'n':
-        n /= power;
-        [[fallthrough]];
-      case 'u':
-        n /= power;
-        [[fallthrough]];
-      case 'm':
-        n /= power;
-        break;
-      case 'E':
-        n *= power;
-        [[fallthrough]];
-      case 'P':
-        n *= power;
-        [[fallthrough]];
-      case 'T':
-        n *= power;
-        [[fallthrough]];
-      case 'G':
-        n *= power;
-        [[fallthrough]];
-      case 'M':
-        n *= power;
-        [[fallthrough]];
-      case 'k':
-      case 'K':
-        n *= power;
-    }
-  }
-  friend std::ostream& operator<<(std::ostream& out, bytes B) {
-    float64_t b = B.n;
-    static const char letters[] = "\00fpnum KMGTPE\00";
-    const char* letter = letters+6;
-    float64_t power = bytes_power_1024 ? 1024. : 1000.;
-    while (letter[0] && letter[-1] && std::abs(b) < 1.) {
-      b *= power;
-      --letter;
-    }
-    while (letter[0] && letter[+1] && std::abs(b) > 999.) {
-      b /= power;
-      ++letter;
-    }
-    if (std::abs(b) < 1e-4) {
-      out << "0 ";
-      if (bytes_power_1024) out << ' ';
-      out << 'B';
-      return out;
+
+// parses a list of read:write mixes (eg: 3:1,4:1)
+bool parse_mixes(const char* str, std::vector<std::pair<int, int>>& mixes) {
+  mixes.clear();
+  while (*str) {
+    char* end = nullptr;
+    long r = std::strtol(str, &end, 10);
+    if (*end != ':') {
+      std::cerr << "error: read/write mix \"" << str << "\" should be \"K:W\"\n";
+      return false;
     }
-    out << b << ' ' << *letter;
-    if (bytes_power_1024) {
-      out << (*letter != ' ' ? 'i' : ' ');
+    long w = std::strtol(end + 1, &end, 10);
+    if (r < 0 || w < 0 || r + w < 1 || r + w > 32) {
+      std::cerr << "error: read/write mix " << r << ':' << w << " should use 1 to 32 arrays\n";
+      return false;
     }
-    out << 'B';
-    return out;
-  }
-
-  operator float64_t() const {
-    return n;
+    mixes.push_back({static_cast<int>(r), static_cast<int>(w)});
+    str = *end ? end + 1 : end;
   }
-};
-
-
-template <class T>
-bool cannot_be_fast(int N) {
-#if defined(__AVX512F__) || defined(__KNC__)
-  constexpr int width = 512;
-  constexpr int regn = 32;
-#elif defined(__AVX__)
-  constexpr int width = 256;
-  constexpr int regn = 16;
-#else
-  constexpr int width = 128;
-#if defined(__aarch64__)
-  constexpr int regn = 32;
-#else
-  constexpr int regn = 16;
-#endif
-#endif
-  constexpr int card = width / (8 * sizeof(T));
-
-  return N != 1 && (N < card || N > card*regn);
-}
-
-template <class T, class F>
-float64_t max_bandwidth(F&& f) {
-  float64_t max_bandwidth = -1./0.;
-  for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
-    if (cannot_be_fast<T>(b->kern)) continue;
-    if (temporal && b->nontemporal) continue;
-    float64_t cur_bandwidth = f(b);
-    max_bandwidth = std::max(max_bandwidth, cur_bandwidth);
-  }
-  return max_bandwidth;
-}
-
-unsigned long long round_down(unsigned long long n, int r) {
-  return (n/r) * r;
-}
-unsigned long long round_up(unsigned long long n, int r) {
-  return round_down(n-1, r)+r;
+  return !mixes.empty();
 }
 
-int get_num_threads() {
-#ifdef _OPENMP
-  int k = 0;
-  OMP(parallel) {
-    OMP(atomic) ++k;
+// parses a list of index patterns (eg: random,clustered), "all" selects every one
+bool parse_patterns(const char* str, std::vector<index_pattern>& patterns) {
+  const index_pattern all[] = {index_pattern::random, index_pattern::sorted, index_pattern::clustered};
+  patterns.clear();
+  while (*str) {
+    const char* end = std::strchr(str, ',');
+    std::string word = end ? std::string(str, end) : std::string(str);
+    bool found = false;
+    for (index_pattern pattern : all) {
+      if (word != pattern_name(pattern) && word != "all") continue;
+      found = true;
+      if (std::find(patterns.begin(), patterns.end(), pattern) == patterns.end()) patterns.push_back(pattern);
+    }
+    if (!found) {
+      std::cerr << "error: unknown index pattern \"" << word << "\"\n";
+      return false;
+    }
+    str = end ? end + 1 : str + word.size();
   }
-#else
-  int k = 1;
-#endif
-  return k;
+  return !patterns.empty();
 }
 
 template <class T>
-void test(const std::vector<long long>& sizes, float64_t cost) {
-  if (CSV) {
-    if (first) {
-      std::cout << "type,size,read,write,copy,incr,scale,add,triad" << std::endl;
-      first = false;
-    }
+void test_type(const std::vector<long long>& sizes, float64_t cost) {
+  if (memops_mode) {
+    test_memops<T>(sizes, cost);
+  } else if (!stream_counts.empty()) {
+    test_streams<T>(sizes, cost);
+  } else if (!strides.empty()) {
+    test_strided<T>(sizes, cost);
+  } else if (!prefetch_distances.empty()) {
+    test_prefetch<T>(sizes, cost);
   } else {
-    std::cout << "Testing bandwidth with type: " << name<T>() << std::endl;
+    test_sweep<T>(sizes, cost);
   }
-  std::cout << std::setprecision(3);
-  const int min_tries = 2, min_repeat = 1;
-
-  int k = get_num_threads();
-  
-  for (long long size : sizes) {
-
-    long long n = size / sizeof(T) / k;
-    int repeat = 1;
-    int tries = 1;
-
-    float64_t cost_ratio = cost / static_cast<float64_t>(n);
-    repeat = std::sqrt(cost_ratio) / 2.;
-
-    float64_t l = std::log2(cost_ratio);
-    if (l < 1.) l = 1.;
-    if (repeat < 1)          repeat = 1;
-    tries = cost_ratio / repeat;
-    repeat *= l;
-    if (tries  < 1)          tries  = 1;
-    if (tries  < min_tries)  tries  = min_tries;
-    //if (tries  > max_tries)  tries  = max_tries;
-    if (repeat < min_repeat) repeat = min_repeat;
-    //if (repeat > max_repeat) repeat = max_repeat;
-
-    if (CSV) {
-      std::cout << name<T>() << ',' << static_cast<float64_t>(n*k*sizeof(T));
-    } else {
-      std::cout << "  size: "     << std::setw(6) << bytes(n*k*sizeof(T));
-      if (verbose) {
-        std::cout << "  repeat: " << std::setw(4) << repeat;
-        std::cout << "  tries: "  << std::setw(4) << tries;
-      }
-      std::cout << std::flush;
-    }
-
-    OMP(parallel firstprivate(n, repeat, tries, k)) {
-      T *buffer = allocate<T>(n + 0x3000 / sizeof(T), 0x1000);
-      if (!buffer) {
-        std::cerr << "Error: Allocation failed. Aborting." << std::endl;
-        abort();
-      }
-      for (long long i = 0; i < (long long)(n + 0x3000 / sizeof(T)); ++i) {
-        buffer[i] = 0;
-      }
-      T *A1 = buffer, *A2 = buffer, *A3 = buffer;
-      T *B2 = reinterpret_cast<T*>(round_up(reinterpret_cast<unsigned long long>(A2 + (n+1)/2), 0x1000));
-      T *B3 = reinterpret_cast<T*>(round_up(reinterpret_cast<unsigned long long>(A3 + (n+2)/3), 0x1000));
-      T *C3 = reinterpret_cast<T*>(round_up(reinterpret_cast<unsigned long long>(B3 + (n+2)/3), 0x1000));
-
-      float64_t read_b = k*max_bandwidth<T>([A1, n, repeat, tries](const bandwidth* b){ return b->read(A1, round_down(n, b->kern), repeat, tries); });
-      OMP(master) {
-        if (CSV) {
-          std::cout << ',' << static_cast<float64_t>(read_b);
-        } else {
-          std::cout << "  \tread: "  << std::setw(6) << bytes(read_b) << "/s" << std::flush;
-        }
-      }
-
-      float64_t write_b = k*max_bandwidth<T>([A1, n, repeat, tries](const bandwidth* b){ return b->write(A1, round_down(n, b->kern), repeat, tries); });
-      OMP(master) {
-        if (CSV) {
-          std::cout << ',' << static_cast<float64_t>(write_b);
-        } else {
-          std::cout << "  \twrite: " << std::setw(6) << bytes(write_b) << "/s" << std::flush;
-        }
-      }
-
-      float64_t copy_b = k*max_bandwidth<T>([A2, B2, n, repeat, tries](const bandwidth* b){ return b->copy(A2, B2, round_down(n/2, b->kern), repeat, tries); });
-      OMP(master) {
-        if (CSV) {
-          std::cout << ',' << static_cast<float64_t>(copy_b);
-        } else {
-          std::cout << "  \tcopy: "  << std::setw(6) << bytes( copy_b) << "/s" << std::flush;
-        }
-      }
-
-      float64_t incr_b = k*max_bandwidth<T>([A2, n, repeat, tries](const bandwidth* b){ return b->incr(A2, round_down(n/2, b->kern), repeat, tries); });
-      OMP(master) {
-        if (CSV) {
-          std::cout << ',' << static_cast<float64_t>(incr_b);
-        } else {
-          std::cout << "  \tincr: "  << std::setw(6) << bytes(incr_b) << "/s" << std::flush;
-        }
-      }
-
-      float64_t scale_b = k*max_bandwidth<T>([A2, B2, n, repeat, tries](const bandwidth* b){ return b->scale(A2, B2, round_down(n/2, b->kern), repeat, tries); });
-      OMP(master) {
-        if (CSV) {
-          std::cout << ',' << static_cast<float64_t>(scale_b);
-        } else {
-          std::cout << "  \tscale: " << std::setw(6) << bytes(scale_b) << "/s" << std::flush;
-        }
-      }
-
-      float64_t add_b = k*max_bandwidth<T>([A3, B3, C3, n, repeat, tries](const bandwidth* b){ return b->add(A3, B3, C3, round_down(n/3, b->kern), repeat, tries); });
-      OMP(master) {
-        if (CSV) {
-          std::cout << ',' << static_cast<float64_t>(add_b);
-        } else {
-          std::cout << "  \tadd: "   << std::setw(6) << bytes(add_b) << "/s" << std::flush;
-        }
-      }
-
-      float64_t triad_b = k*max_bandwidth<T>([A3, B3, C3, n, repeat, tries](const bandwidth* b){ return b->triad(A3, B3, C3, round_down(n/3, b->kern), repeat, tries); });
-      OMP(master) {
-        if (CSV) {
-          std::cout << ',' << static_cast<float64_t>(triad_b);
-        } else {
-          std::cout << "  \ttriad: " << std::setw(6) << bytes(triad_b) << "/s" << std::flush;
-        }
-      }
-
-      deallocate(buffer);
-    }
-
-    std::cout << std::endl;
+}
+void test_type(bandwidth_type type, const std::vector<long long>& sizes, float64_t cost) {
+  if (!patterns.empty()) {
+    test_gather(type, sizes, cost);
+    return;
+  }
+  switch (type) {
+#ifdef F16
+    case bandwidth_type::f16: test_type<float16_t>(sizes, cost); break;
+#endif
+    case bandwidth_type::f32: test_type<float32_t>(sizes, cost); break;
+    case bandwidth_type::f64: test_type<float64_t>(sizes, cost); break;
+    case bandwidth_type::i8:  test_type<int8_t>(sizes, cost); break;
+    case bandwidth_type::i16: test_type<int16_t>(sizes, cost); break;
+    case bandwidth_type::i32: test_type<int32_t>(sizes, cost); break;
+    case bandwidth_type::i64: test_type<int64_t>(sizes, cost); break;
+    default: break;
   }
 }
 
@@ -304,7 +117,10 @@ void test(const std::vector<long long>& sizes, float64_t cost) {
 float64_t default_cost = 1e6;
 long long default_min = bytes("4 KiB");
 long long default_max = bytes("512 MiB");
+long long default_stride = 64;
 float64_t default_density = 2;
+float64_t default_precision = convergence().target;
+float64_t default_budget = convergence().budget;
 
 const char* program_name = "bandwidth";
 void help(std::ostream& out) {
@@ -321,18 +137,87 @@ void help(std::ostream& out) {
   out << "    -d, --density d       sets the density of sizes to tests (default: " << default_density << " per octave)\n";
   out << "    -n, --n   n           sets the number of buffer size being tested to \"n\" (default: 1 + density * log2(max / min) )\n";
   out << "    -c, --cost cost       sets the goal cost of the tests: higher means more retries per test (default: " << default_cost << ")\n";
+  out << "    -e, --precision p     runs tries until the 95% confidence interval of the median is within +-p (eg: 0.01 or 1%)\n";
+  out << "                          instead of a fixed number of tries (default target: " << 100. * default_precision << "%)\n";
+  out << "    -B, --budget seconds  sets the maximum time spent on one op (shared by its kernel variants) when adapting the tries (default: " << default_budget << " s)\n";
   out << "    -s, --size list       sets the buffer size being tested to a specific list "
                                     "(default: n sizes logarithmically spaced from min to max)\n";
+  out << "    -t, --type list       runs only the element types in \"list\": f16, f32, f64, i8, i16, i32, i64,\n";
+  out << "                          \"float\", \"int\" or \"all\" (eg: f32,i64) (default: float)\n";
+  out << "    -y, --summary         prints only the bandwidth per cache level (L1, L2, L3 and DRAM) of every type\n";
   out << "    -i, --binary-prefix   uses binary prefixes (eg: KiB, MiB) for the output\n";
   out << "    -T, --temporal        does not use any non-temporal store instructions";
-  if (temporal) out << " (always ON: non-temporal stores not supported on this architecture)";
+  if (current_isa && !current_isa->nontemporal) out << " (always ON: non-temporal stores not supported on this architecture)";
   out << "\n";
+  out << "    -w, --stores type     runs only the kernels with \"temporal\" or \"nontemporal\" stores (default: all)\n";
+  out << "    -k, --kernels list    runs only the kernels processing \"list\" elements per iteration (eg: 1,8-16)\n";
+  out << "                          (default: the ones that fit the vector registers)\n";
+  out << "    -V, --variants        prints the bandwidth of every kernel variant and which one is the fastest\n";
+  out << "    -K, --mix list        also runs the read/write mixes in \"list\": K:W reads K arrays and writes their sum to W arrays\n";
+  out << "                          (eg: 3:1,4:1), printed after triad (extra CSV columns)\n";
+  out << "    -F, --prefetch list   sweeps the distance of software prefetches (t0, t1, t2 and nta hints) over \"list\"\n";
+  out << "                          (eg: 256,1KiB or auto: 64 B to 8 KiB) and compares the best one with the hardware prefetchers only\n";
+  out << "    -R, --strides list    measures read, write and copy of one element every \"stride\" bytes for each stride in \"list\"\n";
+  out << "                          (eg: 8,64,4KiB or auto: one element to 4 KiB), in useful bytes/s and cache lines/s (Gl/s)\n";
+  out << "    -o, --memops          compares memcpy, memmove, rep movsb and std::copy with the best copy kernel, and memset,\n";
+  out << "                          rep stosb and std::fill with the best write kernel (with a summary per cache level)\n";
+  out << "    -Z, --streams list    reads and writes \"count\" concurrent arrays for each count in \"list\" (eg: 1-32)\n";
+  out << "    -O, --stream-offset size  shifts the start of the array j of the streams by j * \"size\" (multiple of 64 B) (default: 0)\n";
+  out << "    -G, --gather list     measures gather (x = A[idx[i]]), scatter (A[idx[i]] = x) and gather_add (C[i] = A[idx[i]] + B[i])\n";
+  out << "                          with the index patterns in \"list\": random, sorted, clustered or \"all\" (32 and 64-bit types only)\n";
+  out << "    -g, --traffic rate    generates memory traffic at \"rate\" bytes per second over all the threads (eg: 10GB/s, 0: unlimited)\n";
+  out << "                          on buffers of max bytes until SIGINT or SIGTERM, and reports the bandwidth achieved every second\n";
+  out << "    -W, --writes fraction sets the fraction of the traffic that is written (eg: 0.25 or 25%) (default: 0)\n";
+  out << "    -D, --duration s      stops the traffic after \"s\" seconds (default: until signalled)\n";
+  out << "    -Q, --monitor file    measures the probes of \"file\" (\"name ops type size [threads [node]]\" per line, or \"default\")\n";
+  out << "                          periodically, appends them to a history file and compares them with the baseline of the host\n";
+  out << "    -U, --interval s      runs the probes every \"s\" seconds until SIGINT or SIGTERM (0: once) (default: 3600)\n";
+  out << "    -Y, --history file    CSV history of the probes (default: bandwidth-history.csv), the baseline of the host\n";
+  out << "                          being kept in \"file.<host>.baseline\" (the best of its first " << baseline_runs << " runs)\n";
+  out << "    -q, --threshold x     reports the drops below the baseline larger than \"x\" (eg: 0.1 or 10%) (default: 10%)\n";
+  out << "    -u, --alert command   runs the shell command on a drop, with BANDWIDTH_HOST, BANDWIDTH_PROBE, BANDWIDTH_OP,\n";
+  out << "                          BANDWIDTH_VALUE and BANDWIDTH_BASELINE set (\"exit\": exits with status 2 after the run)\n";
+  out << "    -H, --core-to-core cpus  measures the one-way latency (ping-pong) and the bandwidth (producer/consumer ring)\n";
+  out << "                          of cache line transfers between every pair of \"cpus\" (a list, \"all\" or \"sample[:n]\":\n";
+  out << "                          n CPUs spread over the sockets and L3 domains, default: 8)\n";
+  out << "    -l, --latency         measures the load latency with pointer chasing instead of the bandwidth\n";
+  out << "    -L, --loaded op       measures the latency with pointer chasing on one thread while the other ones run \"op\"\n";
+  out << "                          (read, copy or triad) from idle to saturated, and prints the latency vs bandwidth curve\n";
+  out << "    -S, --stride size     sets the distance between two links of the pointer chain (default: " << default_stride << " B)\n";
+  out << "    -N, --cpunodebind list  runs the threads on the CPUs of the NUMA nodes in \"list\" (eg: 0,2-3)\n";
+  out << "    -b, --membind list    allocates the buffers on the NUMA nodes in \"list\"\n";
+  out << "    -I, --interleave list interleaves the buffers over the NUMA nodes in \"list\" (\"all\": every node)\n";
+  out << "    -X, --numa-matrix     measures every cpu node x memory node pair at the largest size and prints the bandwidth matrices\n";
+  out << "    -p, --pages list      sets the pages backing the buffers: 4k, thp (transparent huge pages), 2m or 1g (hugetlb)\n";
+  out << "                          (default: system, as set in /sys/kernel/mm/transparent_hugepage); with several policies\n";
+  out << "                          (eg: 4k,2m), runs the sweep with each one and prints the TLB overhead of the first one\n";
+  out << "    -A, --isa name        uses the kernels compiled for the instruction set \"name\" (available:";
+  for (const bandwidth_isa* const* isa = bandwidth_isas; *isa; ++isa) {
+    if (isa_supported(*isa)) out << ' ' << (*isa)->name;
+  }
+  out << ", default: " << (current_isa ? current_isa->name : "none") << ")\n";
+  out << "    -j, --threads list    runs every size with each number of threads in \"list\" (eg: 1,2,4-8, or all: NPROC)\n";
+  out << "    -J, --scaling         runs every size with 1, 2, 4, ... NPROC threads\n";
+  out << "    -a, --affinity policy pins the threads: compact (fills a socket first), scatter (round-robin over sockets and L3),\n";
+  out << "                          cores (one thread per physical core), smt (both SMT siblings) or none (default: none)\n";
+  out << "    -E, --cold            evicts the buffers from the caches before every try (clflushopt, clflush, dc civac\n";
+  out << "                          or an eviction buffer) and times a single pass over them\n";
+  out << "    -P, --perf            counts hardware events (cycles, instructions, L1D/LLC/dTLB misses and DRAM CAS) with perf_event_open,\n";
+  out << "                          and prints the bytes per core cycle, the actual frequency of the cores and the DRAM traffic\n";
+  out << "                          of every op\n";
+  out << "    -x, --stats file      writes the statistics of the tries of every op (min, median, mean, p95, stddev and cv\n";
+  out << "                          of the durations in seconds) to the CSV file \"file\"\n";
   out << std::flush;
 	return;
 }
 
 int main(int argc, char *argv[]) {
   program_name = argv[0];
+  set_allocation_log([](const char* message) { std::cerr << message << std::endl; });
+  if (!select_isa()) {
+    std::cerr << "error: none of the compiled instruction sets is supported by this CPU" << std::endl;
+    exit(1);
+  }
   int opt, longindex;
   struct optparse options;
   struct optparse_long longopts[] = {
@@ -348,10 +233,48 @@ int main(int argc, char *argv[]) {
     {"type",          't', OPTPARSE_REQUIRED},
     {"binary-prefix", 'i', OPTPARSE_NONE},
     {"temporal",      'T', OPTPARSE_NONE},
+    {"latency",       'l', OPTPARSE_NONE},
+    {"stride",        'S', OPTPARSE_REQUIRED},
+    {"loaded",        'L', OPTPARSE_REQUIRED},
+    {"traffic",       'g', OPTPARSE_REQUIRED},
+    {"writes",        'W', OPTPARSE_REQUIRED},
+    {"duration",      'D', OPTPARSE_REQUIRED},
+    {"cpunodebind",   'N', OPTPARSE_REQUIRED},
+    {"membind",       'b', OPTPARSE_REQUIRED},
+    {"interleave",    'I', OPTPARSE_REQUIRED},
+    {"numa-matrix",   'X', OPTPARSE_NONE},
+    {"pages",         'p', OPTPARSE_REQUIRED},
+    {"isa",           'A', OPTPARSE_REQUIRED},
+    {"threads",       'j', OPTPARSE_REQUIRED},
+    {"scaling",       'J', OPTPARSE_NONE},
+    {"affinity",      'a', OPTPARSE_REQUIRED},
+    {"stats",         'x', OPTPARSE_REQUIRED},
+    {"precision",     'e', OPTPARSE_REQUIRED},
+    {"stores",        'w', OPTPARSE_REQUIRED},
+    {"kernels",       'k', OPTPARSE_REQUIRED},
+    {"variants",      'V', OPTPARSE_NONE},
+    {"perf",          'P', OPTPARSE_NONE},
+    {"cold",          'E', OPTPARSE_NONE},
+    {"summary",       'y', OPTPARSE_NONE},
+    {"budget",        'B', OPTPARSE_REQUIRED},
+    {"prefetch",      'F', OPTPARSE_REQUIRED},
+    {"strides",       'R', OPTPARSE_REQUIRED},
+    {"gather",        'G', OPTPARSE_REQUIRED},
+    {"mix",           'K', OPTPARSE_REQUIRED},
+    {"streams",       'Z', OPTPARSE_REQUIRED},
+    {"memops",        'o', OPTPARSE_NONE},
+    {"core-to-core",  'H', OPTPARSE_REQUIRED},
+    {"monitor",       'Q', OPTPARSE_REQUIRED},
+    {"interval",      'U', OPTPARSE_REQUIRED},
+    {"history",       'Y', OPTPARSE_REQUIRED},
+    {"threshold",     'q', OPTPARSE_REQUIRED},
+    {"alert",         'u', OPTPARSE_REQUIRED},
+    {"stream-offset", 'O', OPTPARSE_REQUIRED},
     {0, 0, OPTPARSE_NONE}
   };
   optparse_init(&options, argv);
   int k = get_num_threads();
+  max_threads = k;
   options.permute = 0;
 
   long long min_size = 0, max_size = 0;
@@ -365,6 +288,8 @@ int main(int argc, char *argv[]) {
   float64_t cost = default_cost;
   float64_t density = default_density;
   std::vector<long long> sizes;
+  std::vector<int> cpu_nodes, mem_nodes;
+  mem_policy policy = mem_policy::local;
 
   while (options.optind < argc) {
     if ((opt = optparse_long(&options, longopts, &longindex)) != -1) {
@@ -406,15 +331,256 @@ int main(int argc, char *argv[]) {
           }
           break;
         case 't': // types
-          std::cerr << "error: -t,--type option not yet implemented\n";
-          help(std::cerr);
-          exit(1);
+          if (!parse_types(options.optarg, types)) {
+            help(std::cerr);
+            exit(1);
+          }
           break;
         case 'i': // binary-prefix
           bytes_power_1024 = true;
           break;
-        case 'T': // binary-prefix
-          temporal = true;
+        case 'T': // temporal stores only
+          filter.temporal = true;
+          filter.nontemporal = false;
+          break;
+        case 'l': // latency
+          latency_mode = true;
+          break;
+        case 'L': // loaded latency
+          {
+            const load_op ops[] = {load_op::read, load_op::copy, load_op::triad};
+            loaded_mode = false;
+            for (load_op op : ops) {
+              if (std::strcmp(options.optarg, load_op_name(op)) == 0) {
+                loaded_op = op;
+                loaded_mode = true;
+              }
+            }
+            if (!loaded_mode) {
+              std::cerr << "error: unknown load op \"" << options.optarg << "\"\n";
+              help(std::cerr);
+              exit(1);
+            }
+          }
+          break;
+        case 'g': // traffic generator
+          traffic_mode = true;
+          traffic_rate = bytes(options.optarg);
+          break;
+        case 'W': // written fraction of the traffic
+          traffic_writes = parse_precision(options.optarg);
+          break;
+        case 'D': // traffic duration
+          traffic_duration = std::stod(options.optarg);
+          break;
+        case 'S': // chain stride
+          chase_stride = bytes(options.optarg);
+          break;
+        case 'N': // cpu nodes
+          cpu_nodes = parse_list(options.optarg);
+          if (std::strcmp(options.optarg, "all") == 0) {
+            cpu_nodes = numa_cpu_nodes();
+          } else if (cpu_nodes.empty()) {
+            std::cerr << "error: invalid list of cpu nodes \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'b': // memory nodes
+          policy = mem_policy::bind;
+          mem_nodes = parse_list(options.optarg);
+          // "all": every node
+          if (mem_nodes.empty() && std::strcmp(options.optarg, "all") != 0) {
+            std::cerr << "error: invalid list of memory nodes \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'I': // interleaved memory nodes
+          policy = mem_policy::interleave;
+          mem_nodes = parse_list(options.optarg);
+          // "all": every node
+          if (mem_nodes.empty() && std::strcmp(options.optarg, "all") != 0) {
+            std::cerr << "error: invalid list of memory nodes \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'X': // NUMA matrix
+          numa_matrix = true;
+          break;
+        case 'A': // instruction set
+          if (!select_isa(options.optarg)) {
+            std::cerr << "error: instruction set \"" << options.optarg << "\" is not available\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'j': // thread counts
+          if (std::strcmp(options.optarg, "all") == 0) {
+            thread_counts = {k};
+          } else {
+            thread_counts = parse_list(options.optarg);
+          }
+          if (thread_counts.empty()) {
+            std::cerr << "error: invalid list of thread counts \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'J': // thread scaling
+          thread_counts.clear();
+          for (int t = 1; t < k; t *= 2) thread_counts.push_back(t);
+          thread_counts.push_back(k);
+          break;
+        case 'a': // affinity
+          if (!parse_affinity(options.optarg, pinning)) {
+            std::cerr << "error: unknown affinity policy \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'x': // statistics file
+          stats_file.open(options.optarg);
+          if (!stats_file) {
+            std::cerr << "error: cannot open \"" << options.optarg << "\"\n";
+            exit(1);
+          }
+          break;
+        case 'w': // store types
+          if (std::strcmp(options.optarg, "temporal") == 0) {
+            filter.temporal = true;
+            filter.nontemporal = false;
+          } else if (std::strcmp(options.optarg, "nontemporal") == 0) {
+            filter.temporal = false;
+            filter.nontemporal = true;
+          } else if (std::strcmp(options.optarg, "all") == 0) {
+            filter.temporal = filter.nontemporal = true;
+          } else {
+            std::cerr << "error: unknown store type \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'F': // software prefetch distances
+          prefetch_distances.clear();
+          if (std::strcmp(options.optarg, "auto") == 0) {
+            for (long long d = 64; d <= 8192; d *= 2) prefetch_distances.push_back(d);
+          } else {
+            const char *p = options.optarg;
+            while (*p) {
+              prefetch_distances.push_back(bytes(p));
+              while (*p && *p != ',') ++p;
+              if (*p) ++p;
+            }
+          }
+          break;
+        case 'R': // strided accesses
+          strides.clear();
+          if (std::strcmp(options.optarg, "auto") == 0) {
+            strides.push_back(0);
+          } else {
+            const char *p = options.optarg;
+            while (*p) {
+              strides.push_back(bytes(p));
+              while (*p && *p != ',') ++p;
+              if (*p) ++p;
+            }
+          }
+          break;
+        case 'G': // gather/scatter index patterns
+          if (!parse_patterns(options.optarg, patterns)) {
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'K': // read/write mixes
+          if (!parse_mixes(options.optarg, mixes)) {
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'Q': // monitoring
+          monitor_probes = options.optarg;
+          break;
+        case 'U': // monitoring interval
+          monitor_interval = std::stod(options.optarg);
+          if (!(monitor_interval >= 0.) || std::isinf(monitor_interval)) {
+            std::cerr << "error: invalid monitoring interval \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'Y': // monitoring history
+          monitor_history = options.optarg;
+          break;
+        case 'q': // monitoring threshold
+          monitor_threshold = parse_precision(options.optarg);
+          break;
+        case 'u': // monitoring alert
+          monitor_alert = options.optarg;
+          break;
+        case 'H': // core-to-core transfers
+          coherence_cpus = options.optarg;
+          break;
+        case 'o': // copy and fill implementations
+          memops_mode = true;
+          break;
+        case 'Z': // concurrent streams
+          stream_counts = parse_list(options.optarg);
+          if (stream_counts.empty() || *std::min_element(stream_counts.begin(), stream_counts.end()) < 1) {
+            std::cerr << "error: invalid list of stream counts \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'O': // offset between the streams
+          stream_offset = bytes(options.optarg);
+          break;
+        case 'k': // kernel widths
+          filter.kernels = parse_list(options.optarg);
+          if (filter.kernels.empty() || *std::min_element(filter.kernels.begin(), filter.kernels.end()) < 1) {
+            std::cerr << "error: invalid list of kernel widths \"" << options.optarg << "\"\n";
+            help(std::cerr);
+            exit(1);
+          }
+          break;
+        case 'y': // summary only
+          summary_only = true;
+          break;
+        case 'P': // hardware counters
+          counters_enabled = true;
+          break;
+        case 'E': // cold caches
+          cold_enabled = true;
+          break;
+        case 'V': // every variant
+          show_variants = true;
+          break;
+        case 'e': // adaptive precision
+          adaptive.enabled = true;
+          adaptive.target = parse_precision(options.optarg);
+          break;
+        case 'B': // adaptive budget
+          adaptive.enabled = true;
+          adaptive.budget = std::stod(options.optarg);
+          break;
+        case 'p': // page sizes
+          {
+            page_policies.clear();
+            std::istringstream list(options.optarg);
+            std::string word;
+            while (std::getline(list, word, ',')) {
+              page_policy pages;
+              if (!parse_page_policy(word.c_str(), pages)) {
+                std::cerr << "error: unknown page policy \"" << word << "\"\n";
+                help(std::cerr);
+                exit(1);
+              }
+              page_policies.push_back(pages);
+            }
+            if (!page_policies.empty()) set_page_policy(page_policies.front());
+          }
           break;
         case '?':
           std::cerr << "error: unrecognized option\n";
@@ -444,6 +610,41 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  for (int threads : thread_counts) {
+    if (threads < 1) {
+      std::cerr << "error: the number of threads (" << threads << ") should be positive" << std::endl;
+      help(std::cerr);
+      exit(1);
+    }
+    max_threads = std::max(max_threads, threads);
+  }
+
+  if (chase_stride < 1) {
+    chase_stride = default_stride;
+  }
+  for (int count : stream_counts) {
+    if (count < 1) {
+      std::cerr << "error: the number of streams (" << count << ") should be positive" << std::endl;
+      help(std::cerr);
+      exit(1);
+    }
+  }
+  if (stream_offset < 0 || stream_offset % 64 != 0) {
+    std::cerr << "error: the stream offset (" << bytes(stream_offset) << ") should be a multiple of 64 B" << std::endl;
+    help(std::cerr);
+    exit(1);
+  }
+  if (adaptive.enabled && (!(adaptive.target > 0.) || !(adaptive.budget > 0.))) {
+    std::cerr << "error: the precision (" << adaptive.target << ") and the budget (" << adaptive.budget << " s) should be positive" << std::endl;
+    help(std::cerr);
+    exit(1);
+  }
+  if (chase_stride < (long long) sizeof(void*) || chase_stride % sizeof(void*) != 0) {
+    std::cerr << "error: stride (" << bytes(chase_stride) << ") should be a multiple of the pointer size (" << sizeof(void*) << " B)" << std::endl;
+    help(std::cerr);
+    exit(1);
+  }
+
   if (min_size > max_size) {
     std::cerr << "error: min (" << bytes(min_size) << ") should not be larger than max (" << bytes(max_size) << ")" << std::endl;
     help(std::cerr);
@@ -456,6 +657,7 @@ int main(int argc, char *argv[]) {
   }
 
   float64_t granularity = k*bytes("1 KiB");
+  caches = cache_levels();
 
   if (sizes.size() == 0) {
     sizes.resize(n);
@@ -472,9 +674,26 @@ int main(int argc, char *argv[]) {
         sizes[i] = std::max(min_size, sizes[i]);
       }
       sizes.back() = max_size;
+    }
 
-      sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    // more sizes around the cache boundaries (for the largest number of threads)
+    for (const cache_level& c : caches) {
+      if (n == 1) break;
+      float64_t capacity = cache_capacity(c, max_threads);
+      for (float64_t ratio : {0.5, 0.75, 1., 1.5, 2.}) {
+        long long s = granularity * std::round(ratio * capacity / granularity);
+        if (min_size <= s && s <= max_size) sizes.push_back(s);
+      }
     }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+  }
+  if (types.empty()) parse_types("float", types);
+  if (page_policies.size() > 1 && (memops_mode || !stream_counts.empty() || !strides.empty() || !prefetch_distances.empty() || numa_matrix ||
+                                   !patterns.empty() || latency_mode || loaded_mode || traffic_mode || monitor_probes || coherence_cpus)) {
+    std::cerr << "error: several page policies are only compared by the bandwidth sweep" << std::endl;
+    help(std::cerr);
+    exit(1);
   }
 
   if (verbose) {
@@ -491,14 +710,117 @@ int main(int argc, char *argv[]) {
 #endif
 
     std::cerr << "min: " << bytes(min_size) << "\tmax: " << bytes(max_size) << "\tcost: " << cost << "\tn: " << n << " (" << sizes.size() << ")\tgranularity: " << bytes(granularity) << std::endl;
+    std::cerr << "timer: " << Timer::frequency * 1e-9 << " GHz" << (Timer::invariant ? " (invariant)" : " (not invariant)") << std::endl;
+    std::cerr << "caches:";
+    if (caches.empty()) std::cerr << " unknown";
+    for (const cache_level& c : caches) std::cerr << "\tL" << c.level << ": " << bytes(c.size) << " x " << c.instances;
+    std::cerr << std::endl;
+    std::cerr << "cpu nodes: ";
+    if (cpu_nodes.empty()) std::cerr << "any";
+    for (unsigned i = 0; i < cpu_nodes.size(); ++i) std::cerr << (i ? "," : "") << cpu_nodes[i];
+    std::cerr << "\tmemory: " << mem_policy_name(policy);
+    if (policy != mem_policy::local) {
+      std::cerr << " ";
+      if (mem_nodes.empty()) std::cerr << "all";
+      for (unsigned i = 0; i < mem_nodes.size(); ++i) std::cerr << (i ? "," : "") << mem_nodes[i];
+    }
+    std::cerr << "\tpages: " << page_policy_name(get_page_policy());
+    std::cerr << "\tisa: " << current_isa->name;
+    std::cerr << "\taffinity: " << affinity_name(pinning);
+    std::cerr << "\ttypes:";
+    for (bandwidth_type type : types) std::cerr << ' ' << type_name(type);
+    std::cerr << "\tstores: " << (!filter.nontemporal ? "temporal" : !filter.temporal ? "nontemporal" : "all");
+    if (!filter.kernels.empty()) std::cerr << "\tkernels: " << format_list(filter.kernels);
+    if (!prefetch_distances.empty()) {
+      std::cerr << "\tprefetch distances:";
+      for (long long d : prefetch_distances) std::cerr << ' ' << bytes(d);
+    }
+    if (adaptive.enabled) std::cerr << "\tprecision: " << 100. * adaptive.target << "%\tbudget: " << adaptive.budget << " s";
+    std::cerr << std::endl;
   }
 
-#ifdef F16
-  test<float16_t>(sizes, cost);
-#endif
-  test<float32_t>(sizes, cost);
-  test<float64_t>(sizes, cost);
+  if (!Timer::invariant) {
+    std::cerr << "Warning: The timer is not invariant: its rate follows the frequency of the cores (use -P for the actual cycles)" << std::endl;
+  }
+  if (cold_enabled && !cold_init()) {
+    std::cerr << "error: Failed to allocate the eviction buffer of the cold cache mode" << std::endl;
+    return 1;
+  }
+  if (counters_enabled) {
+    counters_enabled = counters_init();
+    if (counters_enabled) std::atexit(counters_fini);
+    if (!counters_enabled) {
+      std::cerr << "Warning: No hardware counter available (see /proc/sys/kernel/perf_event_paranoid)" << std::endl;
+    } else if (CSV && !stats_file.is_open()) {
+      std::cerr << "Warning: In CSV mode, the hardware counts are only written to the statistics file (-x)" << std::endl;
+    }
+  }
+  if (stats_file.is_open()) {
+    stats_file << std::setprecision(6) << "type,size,threads,op,bytes,tries,min,median,mean,p95,stddev,cv";
+    if (counters_enabled) {
+      for (int event = 0; event < nb_events; ++event) stats_file << ',' << event_name(event);
+    }
+    stats_file << '\n';
+  }
+
+  if (!current_isa->nontemporal) {
+    if (!filter.temporal) {
+      std::cerr << "error: non-temporal stores are not supported on this architecture" << std::endl;
+      exit(1);
+    }
+    filter.nontemporal = false;
+  }
+  {
+    bool any = false;
+    for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
+      if (!filter.nontemporal && b->nontemporal) continue;
+      if (!filter.temporal && !b->nontemporal) continue;
+      if (!filter.kernels.empty() && std::find(filter.kernels.begin(), filter.kernels.end(), b->kern) == filter.kernels.end()) continue;
+      any = true;
+    }
+    if (!any) {
+      std::cerr << "error: no kernel matches the requested widths and store types" << std::endl;
+      help(std::cerr);
+      exit(1);
+    }
+  }
+
+  set_mem_policy(policy, mem_nodes);
+  allowed_cpus = process_cpus();
+  if (!cpu_nodes.empty()) {
+    bind_threads(cpu_nodes);
+  }
+
+  if (coherence_cpus) {
+    test_coherence(cost);
+    return 0;
+  }
+  if (monitor_probes) {
+    return run_monitor(cost);
+  }
+  if (traffic_mode) {
+    if (!(traffic_writes >= 0. && traffic_writes <= 1.) || traffic_rate < 0.) {
+      std::cerr << "error: the written fraction (" << traffic_writes << ") should be between 0 and 1, and the rate positive" << std::endl;
+      help(std::cerr);
+      exit(1);
+    }
+    run_traffic(sizes.back());
+    return 0;
+  }
+  if (loaded_mode) {
+    test_loaded(sizes, cost);
+    return 0;
+  }
+  if (latency_mode) {
+    test_latency(sizes, cost);
+    return 0;
+  }
+
+  for (bandwidth_type type : types) {
+    test_type(type, sizes, cost);
+  }
 
 
   return 0;
 }
+
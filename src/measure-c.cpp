@@ -0,0 +1,37 @@
+#include "measure-c.h"
+#include "measure.h"
+
+void bw_default_options(bw_options* options) {
+  const measure_options defaults;
+  options->cost = defaults.cost;
+  options->repeat = defaults.repeat;
+  options->tries = defaults.tries;
+  options->temporal = defaults.variants.temporal;
+  options->nontemporal = defaults.variants.nontemporal;
+}
+
+int bw_measure(bw_op op, bw_type type, long long size, int threads, const bw_options* options, bw_result* result) {
+  measure_options o;
+  if (options) {
+    o.cost = options->cost;
+    o.repeat = options->repeat;
+    o.tries = options->tries;
+    o.variants.temporal = options->temporal != 0;
+    o.variants.nontemporal = options->nontemporal != 0;
+  }
+  const measure_result r = measure(static_cast<bandwidth_op>(op), static_cast<bandwidth_type>(type), size, threads, o);
+  result->error = r.error;
+  result->bandwidth = r.bandwidth;
+  result->bytes = r.bytes;
+  result->kern = r.kern;
+  result->nontemporal = r.nontemporal;
+  result->repeat = r.repeat;
+  result->tries = r.st.count;
+  result->min = r.st.min;
+  result->median = r.st.median;
+  result->mean = r.st.mean;
+  result->p95 = r.st.p95;
+  result->stddev = r.st.stddev;
+  result->cv = r.st.cv;
+  return r.error ? -1 : 0;
+}
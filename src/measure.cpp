@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cmath>
+#include "allocation.h"
+#include "cold.h"
+#include "measure.h"
+#include "omp-helper.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+const char* op_name(bandwidth_op op) {
+  switch (op) {
+    case bandwidth_op::read:  return "read";
+    case bandwidth_op::write: return "write";
+    case bandwidth_op::copy:  return "copy";
+    case bandwidth_op::incr:  return "incr";
+    case bandwidth_op::scale: return "scale";
+    case bandwidth_op::add:   return "add";
+    case bandwidth_op::triad: return "triad";
+  }
+  return "";
+}
+
+const char* type_name(bandwidth_type type) {
+  switch (type) {
+    case bandwidth_type::f16: return "f16";
+    case bandwidth_type::f32: return "f32";
+    case bandwidth_type::f64: return "f64";
+    case bandwidth_type::i8:  return "i8";
+    case bandwidth_type::i16: return "i16";
+    case bandwidth_type::i32: return "i32";
+    case bandwidth_type::i64: return "i64";
+  }
+  return "";
+}
+
+const char* hint_name(int hint) {
+  switch (hint) {
+    case prefetch_nta: return "nta";
+    case prefetch_t2:  return "t2";
+    case prefetch_t1:  return "t1";
+    case prefetch_t0:  return "t0";
+  }
+  return "none";
+}
+
+int type_size(bandwidth_type type) {
+  switch (type) {
+#ifdef F16
+    case bandwidth_type::f16: return sizeof(float16_t);
+#else
+    case bandwidth_type::f16: return 0;
+#endif
+    case bandwidth_type::f32: return sizeof(float32_t);
+    case bandwidth_type::f64: return sizeof(float64_t);
+    case bandwidth_type::i8:  return sizeof(int8_t);
+    case bandwidth_type::i16: return sizeof(int16_t);
+    case bandwidth_type::i32: return sizeof(int32_t);
+    case bandwidth_type::i64: return sizeof(int64_t);
+  }
+  return 0;
+}
+
+bool cannot_be_fast(int kern, int elem_size) {
+  const int width = current_isa->width;
+  const int regn = current_isa->registers;
+  const int card = width / (8 * elem_size);
+
+  return kern != 1 && (kern < card || kern > card*regn);
+}
+
+bool selected(const bandwidth* b, int elem_size, const variant_filter& filter) {
+  if (!filter.nontemporal && b->nontemporal) return false;
+  if (!filter.temporal && !b->nontemporal) return false;
+  if (!filter.kernels.empty()) return std::find(filter.kernels.begin(), filter.kernels.end(), b->kern) != filter.kernels.end();
+  return !cannot_be_fast(b->kern, elem_size);
+}
+
+void get_repeat_tries(float64_t cost, long long n, int& repeat, int& tries) {
+  const int min_tries = 2, min_repeat = 1;
+
+  float64_t cost_ratio = cost / static_cast<float64_t>(n);
+  repeat = std::sqrt(cost_ratio) / 2.;
+
+  float64_t l = std::log2(cost_ratio);
+  if (l < 1.) l = 1.;
+  if (repeat < 1)          repeat = 1;
+  tries = cost_ratio / repeat;
+  repeat *= l;
+  if (tries  < 1)          tries  = 1;
+  if (tries  < min_tries)  tries  = min_tries;
+  //if (tries  > max_tries)  tries  = max_tries;
+  if (repeat < min_repeat) repeat = min_repeat;
+  //if (repeat > max_repeat) repeat = max_repeat;
+
+  // cold caches: bench() times a single pass per try, the repetitions become tries
+  if (cold_enabled) {
+    tries *= repeat;
+    repeat = 1;
+  }
+  // adaptive measurement: bench() runs more tries until convergence
+  if (adaptive.enabled) tries = adaptive.min_tries;
+}
+
+namespace {
+  template <class T>
+  measure_result measure(bandwidth_op op, long long size, int threads, const measure_options& options) {
+    measure_result r;
+    long long n = size / sizeof(T) / threads;
+    if (n < 1) {
+      r.error = "the buffers are smaller than one element per thread";
+      return r;
+    }
+    int repeat = 1, tries = 1;
+    get_repeat_tries(options.cost, n, repeat, tries);
+    if (options.repeat > 0) repeat = options.repeat;
+    if (options.tries > 0) tries = options.tries;
+    r.repeat = repeat;
+
+    bool failed = false;
+    OMP(parallel num_threads(threads) firstprivate(n, repeat, tries)) {
+      T *buffer = allocate<T>(n + 0x3000 / sizeof(T), 0x1000);
+      if (!buffer) {
+        OMP(atomic write) failed = true;
+      }
+      OMP(barrier);
+      if (!failed) {
+        for (long long i = 0; i < (long long)(n + 0x3000 / sizeof(T)); ++i) {
+          buffer[i] = 0;
+        }
+        buffers<T> x(buffer, n);
+#ifdef _OPENMP
+        const int team = omp_get_num_threads();
+#else
+        const int team = 1;
+#endif
+        // the variants share the adaptive budget
+        int count = 0;
+        for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
+          if (selected(b, sizeof(T), options.variants)) ++count;
+        }
+        OMP(master) samples_budget_split(count);
+        for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
+          if (!selected(b, sizeof(T), options.variants)) continue;
+          // scaled by the threads actually run (the team may be smaller than requested, 1 without OpenMP)
+          float64_t bw = team * run_op<T>(b, op, x, n, repeat, tries);
+          OMP(master) {
+            if (bw > r.bandwidth) {
+              r.bandwidth = bw;
+              r.kern = b->kern;
+              r.nontemporal = b->nontemporal;
+              r.tries = samples();
+            }
+          }
+        }
+      }
+      if (buffer) deallocate(buffer);
+    }
+
+    if (failed) {
+      r = measure_result();
+      r.error = "the buffers could not be allocated";
+      return r;
+    }
+    if (r.bandwidth <= 0.) {
+      r.error = "no selected kernel variant fits the buffers";
+      return r;
+    }
+    r.st = compute_stats(r.tries);
+    r.bytes = r.bandwidth * r.st.min;
+    return r;
+  }
+}
+
+measure_result measure(bandwidth_op op, bandwidth_type type, long long size, int threads, const measure_options& options) {
+  measure_result failed;
+  if (!current_isa && !select_isa()) {
+    failed.error = "no instruction set supported";
+    return failed;
+  }
+  if (threads < 1) threads = 1;
+  try {
+    switch (type) {
+#ifdef F16
+      case bandwidth_type::f16: return measure<float16_t>(op, size, threads, options);
+#endif
+      case bandwidth_type::f32: return measure<float32_t>(op, size, threads, options);
+      case bandwidth_type::f64: return measure<float64_t>(op, size, threads, options);
+      case bandwidth_type::i8:  return measure<int8_t>(op, size, threads, options);
+      case bandwidth_type::i16: return measure<int16_t>(op, size, threads, options);
+      case bandwidth_type::i32: return measure<int32_t>(op, size, threads, options);
+      case bandwidth_type::i64: return measure<int64_t>(op, size, threads, options);
+      default: break;
+    }
+  } catch (...) {
+    failed.error = "out of memory";
+    return failed;
+  }
+  failed.error = "type not supported by this build";
+  return failed;
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstring>
+#include "memops.h"
+#include "bench.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAS_REP_STRING
+#endif
+
+namespace {
+  template <class T>
+  float64_t std_copy(const void* A, void* B, long long size, int repeat, int tries) noexcept {
+    const T* a = static_cast<const T*>(A);
+    T* b = static_cast<T*>(B);
+    long long n = size / sizeof(T);
+    return 2*sizeof(T) * n / bench([a, b, n]{ std::copy(a, a + n, b); }, repeat, tries);
+  }
+  template <class T>
+  float64_t std_fill(void* A, long long size, int repeat, int tries) noexcept {
+    T* a = static_cast<T*>(A);
+    long long n = size / sizeof(T);
+    return sizeof(T) * n / bench([a, n]{ std::fill(a, a + n, T(0)); }, repeat, tries);
+  }
+}
+
+const char* copy_impl_name(copy_impl impl) {
+  switch (impl) {
+    case copy_impl::memcpy:   return "memcpy";
+    case copy_impl::memmove:  return "memmove";
+    case copy_impl::movsb:    return "movsb";
+    case copy_impl::std_copy: return "std::copy";
+  }
+  return "";
+}
+
+const char* fill_impl_name(fill_impl impl) {
+  switch (impl) {
+    case fill_impl::memset:   return "memset";
+    case fill_impl::stosb:    return "stosb";
+    case fill_impl::std_fill: return "std::fill";
+  }
+  return "";
+}
+
+bool copy_impl_available(copy_impl impl) noexcept {
+#ifndef HAS_REP_STRING
+  if (impl == copy_impl::movsb) return false;
+#endif
+  (void) impl;
+  return true;
+}
+
+bool fill_impl_available(fill_impl impl) noexcept {
+#ifndef HAS_REP_STRING
+  if (impl == fill_impl::stosb) return false;
+#endif
+  (void) impl;
+  return true;
+}
+
+float64_t copy_bandwidth(copy_impl impl, const void* A, void* B, long long size, int elem_size, int repeat, int tries) noexcept {
+  if (size <= 0 || !copy_impl_available(impl)) return 0.;
+  switch (impl) {
+    case copy_impl::memcpy:
+      return 2. * size / bench([A, B, size]{ std::memcpy(B, A, size); asm volatile ("" ::: "memory"); }, repeat, tries);
+    case copy_impl::memmove:
+      return 2. * size / bench([A, B, size]{ std::memmove(B, A, size); asm volatile ("" ::: "memory"); }, repeat, tries);
+    case copy_impl::movsb:
+#ifdef HAS_REP_STRING
+      return 2. * size / bench([A, B, size]{
+        const void* s = A;
+        void* d = B;
+        unsigned long c = size;
+        asm volatile ("rep movsb" : "+D"(d), "+S"(s), "+c"(c) : : "memory");
+      }, repeat, tries);
+#else
+      return 0.;
+#endif
+    case copy_impl::std_copy:
+      switch (elem_size) {
+        case 1: return std_copy<int8_t>(A, B, size, repeat, tries);
+        case 2: return std_copy<int16_t>(A, B, size, repeat, tries);
+        case 4: return std_copy<int32_t>(A, B, size, repeat, tries);
+        case 8: return std_copy<int64_t>(A, B, size, repeat, tries);
+      }
+      return 0.;
+  }
+  return 0.;
+}
+
+float64_t fill_bandwidth(fill_impl impl, void* A, long long size, int elem_size, int repeat, int tries) noexcept {
+  if (size <= 0 || !fill_impl_available(impl)) return 0.;
+  switch (impl) {
+    case fill_impl::memset:
+      return static_cast<float64_t>(size) / bench([A, size]{ std::memset(A, 0, size); asm volatile ("" ::: "memory"); }, repeat, tries);
+    case fill_impl::stosb:
+#ifdef HAS_REP_STRING
+      return static_cast<float64_t>(size) / bench([A, size]{
+        void* d = A;
+        unsigned long c = size;
+        asm volatile ("rep stosb" : "+D"(d), "+c"(c) : "a"(0) : "memory");
+      }, repeat, tries);
+#else
+      return 0.;
+#endif
+    case fill_impl::std_fill:
+      switch (elem_size) {
+        case 1: return std_fill<int8_t>(A, size, repeat, tries);
+        case 2: return std_fill<int16_t>(A, size, repeat, tries);
+        case 4: return std_fill<int32_t>(A, size, repeat, tries);
+        case 8: return std_fill<int64_t>(A, size, repeat, tries);
+      }
+      return 0.;
+  }
+  return 0.;
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "cli.h"
+#include "coherence.h"
+#include "modes.h"
+#include "placement.h"
+
+namespace {
+  // CPUs of the core-to-core matrix: a list, "all" the allowed CPUs, or "sample[:n]" n CPUs (default: 8)
+  // spread over the sockets and L3 domains
+  std::vector<int> coherence_set(const char* str) {
+    std::vector<int> allowed = process_cpus();
+    if (std::strcmp(str, "all") == 0) return allowed;
+    if (std::strncmp(str, "sample", 6) == 0) {
+      int n = str[6] == ':' ? std::atoi(str + 7) : 8;
+      if (n > (int) allowed.size()) n = allowed.size();
+      std::vector<int> cpus = affinity_cpus(affinity::scatter, n, allowed);
+      std::sort(cpus.begin(), cpus.end());
+      cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+      return cpus;
+    }
+    return parse_list(str);
+  }
+}
+
+// one-way latency of a cache line and bandwidth from a producer to a consumer thread for every pair of CPUs
+// (rows: writer, columns: reader)
+void test_coherence(float64_t cost) {
+  const std::vector<int> cpus = coherence_set(coherence_cpus);
+  const int n = cpus.size();
+  if (n < 2) {
+    std::cerr << "error: the core-to-core matrix needs at least 2 cpus (got: " << format_list(cpus) << ")" << std::endl;
+    exit(1);
+  }
+  const int tries = 5;
+  const long long rounds = std::max(100ll, static_cast<long long>(cost / 1000.));
+  const long long volume = std::max(64 * coherence_block, static_cast<long long>(16. * cost));
+  std::vector<std::vector<float64_t>> latencies(n, std::vector<float64_t>(n, 0.)), bandwidths = latencies;
+
+  std::cout << std::setprecision(3);
+  if (CSV) {
+    if (first) {
+      std::cout << "cpu_a,cpu_b,latency,bandwidth" << std::endl;
+      first = false;
+    }
+  } else {
+    std::cout << "Testing core-to-core transfers on cpus " << format_list(cpus) << " (round trips: " << rounds;
+    std::cout << ", bytes: " << bytes(volume) << ", block: " << bytes(coherence_block) << ")" << std::endl;
+  }
+  bool failed = false;
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      if (i == j) continue;
+      latencies[i][j] = pingpong_latency(cpus[i], cpus[j], rounds, tries);
+      bandwidths[i][j] = transfer_bandwidth(cpus[i], cpus[j], volume, tries);
+      if (latencies[i][j] <= 0. || bandwidths[i][j] <= 0.) failed = true;
+      if (CSV) {
+        std::cout << cpus[i] << ',' << cpus[j] << ',' << latencies[i][j] << ',' << bandwidths[i][j] << std::endl;
+      } else if (verbose) {
+        std::cerr << "  cpu " << cpus[i] << " -> " << cpus[j] << ": " << latencies[i][j] * 1e9 << " ns, " << bytes(bandwidths[i][j]) << "/s" << std::endl;
+      }
+    }
+  }
+  if (failed) {
+    std::cerr << "Warning: Some threads could not be pinned (their pairs are reported as 0)" << std::endl;
+  }
+
+  if (CSV) return;
+  std::cout << "Latency matrix (one way, rows: writer, columns: reader)" << std::endl;
+  std::cout << "        ";
+  for (int cpu : cpus) std::cout << "  \tcpu " << std::setw(3) << cpu;
+  std::cout << std::endl;
+  for (int i = 0; i < n; ++i) {
+    std::cout << "  cpu " << std::setw(3) << cpus[i];
+    for (int j = 0; j < n; ++j) {
+      if (i == j) std::cout << "  \t" << std::setw(7) << "-";
+      else std::cout << "  \t" << std::setw(4) << latencies[i][j] * 1e9 << " ns";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "Bandwidth matrix (rows: writer, columns: reader)" << std::endl;
+  std::cout << "        ";
+  for (int cpu : cpus) std::cout << "  \t   cpu " << std::setw(3) << cpu;
+  std::cout << std::endl;
+  for (int i = 0; i < n; ++i) {
+    std::cout << "  cpu " << std::setw(3) << cpus[i];
+    for (int j = 0; j < n; ++j) {
+      if (i == j) std::cout << "  \t" << std::setw(10) << "-";
+      else std::cout << "  \t" << std::setw(6) << bytes(bandwidths[i][j]) << "/s";
+    }
+    std::cout << std::endl;
+  }
+}
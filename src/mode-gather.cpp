@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bandwidth.h"
+#include "cli.h"
+#include "gather.h"
+#include "measure.h"
+#include "modes.h"
+#include "omp-helper.h"
+#include "stats.h"
+
+namespace {
+  // runs the op "op" of the kernels "g" on the buffers of one thread: a table A of m elements, the
+  // indexes of n accesses, and B and C of n elements
+  template <class T>
+  float64_t run_gather(const gather_bandwidth* g, int op, T* A, const int32_t* idx, T* B, T* C, long long n, int repeat, int tries) {
+    switch (op) {
+      case 0: return g->gather(A, idx, round_down(n, g->kern), repeat, tries);
+      case 1: return g->scatter(A, idx, round_down(n, g->kern), repeat, tries);
+      case 2: return g->gather_add(A, idx, B, C, round_down(n, g->kern), repeat, tries);
+    }
+    return 0.;
+  }
+
+  // gathers from and scatters to a table through an index array (one access per element of the table),
+  // for every index pattern: bytes per second of the elements and of the indexes
+  template <class T>
+  void test_gather(const std::vector<long long>& sizes, float64_t cost) {
+    const int nb_gather = 3;
+    const char* gather_names[nb_gather] = {"gather", "scatter", "gather_add"};
+    print_header("type,size,pattern,gather,scatter,gather_add", std::string("Testing gather/scatter with type: ") + name<T>());
+    std::cout << std::setprecision(3);
+
+    for (point p : sweep(sizes)) {
+      long long size = p.size;
+      int k = p.threads;
+      set_num_threads(k);
+      std::vector<int> cpus = pin_threads(k);
+
+      // elements of the table of one thread, and accesses per pass
+      long long m = size / sizeof(T) / k;
+      long long n = round_down(m, 64);
+      if (n < 1) continue;
+      if (m > 0x7fffffffLL) {
+        std::cerr << "Warning: size " << bytes(size) << " skipped (more than 2^31 elements per thread for 32-bit indexes)" << std::endl;
+        continue;
+      }
+      int repeat = 1;
+      int tries = 1;
+      get_repeat_tries(cost, n, repeat, tries);
+
+      for (index_pattern pattern : patterns) {
+        long long tries_start = samples_total();
+        if (CSV) {
+          std::cout << name<T>() << ',' << static_cast<float64_t>(m*k*sizeof(T)) << ',' << pattern_name(pattern);
+        } else {
+          std::ostringstream details;
+          details << "  pattern: " << std::setw(9) << std::left << pattern_name(pattern);
+          print_point(m*k*sizeof(T), k, repeat, tries, cpus, details.str());
+          std::cout << std::flush;
+        }
+
+        std::array<float64_t, nb_gather> row = {};
+        OMP(parallel firstprivate(m, n, repeat, tries)) {
+          // A (m elements), idx (n indexes), B and C (n elements), each one page aligned
+          long long table = round_up(m * sizeof(T), 0x1000), indexes = round_up(n * sizeof(int32_t), 0x1000), array = round_up(n * sizeof(T), 0x1000);
+          char *buffer = allocate_or_abort<char>(table + indexes + 2 * array, 0x1000);
+          T *A = reinterpret_cast<T*>(buffer);
+          int32_t *idx = reinterpret_cast<int32_t*>(buffer + table);
+          T *B = reinterpret_cast<T*>(buffer + table + indexes);
+          T *C = reinterpret_cast<T*>(buffer + table + indexes + array);
+          for (long long i = 0; i < m; ++i) A[i] = 0;
+          for (long long i = 0; i < n; ++i) B[i] = C[i] = 0;
+          make_indexes(idx, n, m, pattern);
+
+          for (int op = 0; op < nb_gather; ++op) {
+            float64_t best = 0.;
+            for (const gather_bandwidth* g = gather_benches; g->kern != 0; ++g) {
+              if (filter.kernels.empty() ? cannot_be_fast(g->kern, sizeof(T)) : std::find(filter.kernels.begin(), filter.kernels.end(), g->kern) == filter.kernels.end()) continue;
+              best = std::max(best, run_gather(g, op, A, idx, B, C, n, repeat, tries));
+            }
+            OMP(master) row[op] = k * best;
+          }
+
+          deallocate(buffer);
+        }
+
+        long long tries_used = samples_total() - tries_start;
+        if (CSV) {
+          for (int op = 0; op < nb_gather; ++op) std::cout << ',' << row[op];
+          print_config_row(k, tries_used);
+        } else {
+          for (int op = 0; op < nb_gather; ++op) {
+            std::cout << "  \t" << gather_names[op] << ": " << std::setw(6) << bytes(row[op]) << "/s";
+          }
+          if (verbose && adaptive.enabled) std::cout << "  \ttries: " << tries_used;
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+}
+// gather/scatter instructions only exist for 32 and 64-bit elements
+void test_gather(bandwidth_type type, const std::vector<long long>& sizes, float64_t cost) {
+  switch (type) {
+    case bandwidth_type::f32: test_gather<float32_t>(sizes, cost); break;
+    case bandwidth_type::f64: test_gather<float64_t>(sizes, cost); break;
+    case bandwidth_type::i32: test_gather<int32_t>(sizes, cost); break;
+    case bandwidth_type::i64: test_gather<int64_t>(sizes, cost); break;
+    default:
+      std::cerr << "Warning: type " << type_name(type) << " skipped (gather/scatter needs 32 or 64-bit elements)" << std::endl;
+      break;
+  }
+}
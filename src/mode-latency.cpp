@@ -0,0 +1,146 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "cli.h"
+#include "latency.h"
+#include "loaded.h"
+#include "measure.h"
+#include "modes.h"
+#include "omp-helper.h"
+#include "placement.h"
+#include "stats.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+void test_latency(const std::vector<long long>& sizes, float64_t cost) {
+  print_header("type,size,latency", "Testing latency with pointer chasing (stride: " + std::to_string(chase_stride) + " B)");
+  std::cout << std::setprecision(3);
+
+  for (point p : sweep(sizes)) {
+    long long size = p.size;
+    int k = p.threads;
+    set_num_threads(k);
+    std::vector<int> cpus = pin_threads(k);
+
+    // number of links per thread
+    long long n = size / chase_stride / k;
+    if (n < 1) n = 1;
+    int repeat = 1;
+    int tries = 1;
+    get_repeat_tries(cost, n, repeat, tries);
+    long long tries_start = samples_total();
+
+    if (CSV) {
+      std::cout << "ptr," << static_cast<float64_t>(n*k*chase_stride);
+    } else {
+      print_point(n*k*chase_stride, k, repeat, tries, cpus);
+      std::cout << std::flush;
+    }
+
+    OMP(parallel firstprivate(n, repeat, tries)) {
+      void *buffer = allocate_or_abort(n * chase_stride, 0x1000);
+      void *chain = make_chain(buffer, n * chase_stride, chase_stride);
+
+      float64_t latency_s = latency(chain, n, repeat, tries);
+      OMP(master) {
+        if (CSV) {
+          std::cout << ',' << latency_s;
+        } else {
+          std::cout << "  \tlatency: " << std::setw(6) << latency_s * 1e9 << " ns" << std::flush;
+        }
+      }
+
+      deallocate(buffer);
+    }
+
+    // tries run for this point (every op and variant)
+    long long tries_used = samples_total() - tries_start;
+    if (CSV) {
+      print_config_row(k, tries_used);
+    } else if (verbose && adaptive.enabled) {
+      std::cout << "  \ttries: " << tries_used;
+    }
+    std::cout << std::endl;
+  }
+}
+
+
+// latency of the pointer chase of the first thread while the other ones run "loaded_op" at increasing
+// intensities (fraction of the time spent in the kernel): latency vs delivered bandwidth curve
+void test_loaded(const std::vector<long long>& sizes, float64_t cost) {
+  const float64_t intensities[] = {0., 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.};
+  print_header("type,size,op,intensity,latency,bandwidth", "Testing loaded latency with pointer chasing (stride: " + std::to_string(chase_stride) + " B) and " +
+               load_op_name(loaded_op) + " traffic");
+  std::cout << std::setprecision(3);
+
+  for (point p : sweep(sizes)) {
+    long long size = p.size;
+    int k = p.threads;
+    if (k < 2) {
+      std::cerr << "Warning: loaded latency needs at least 2 threads (one chasing, the others loading), use -j" << std::endl;
+      return;
+    }
+    set_num_threads(k);
+    std::vector<int> cpus = pin_threads(k);
+
+    // number of links of the chain, and bytes of the buffer of every loading thread
+    long long n = size / chase_stride / k;
+    if (n < 1) n = 1;
+    long long m = round_down(size / k, 0x1000);
+    int repeat = 1;
+    int tries = 1;
+    get_repeat_tries(cost, n, repeat, tries);
+    // the traffic runs the fastest variant of the op on the buffers of the loading threads
+    const bandwidth_op op = loaded_op == load_op::read ? bandwidth_op::read : loaded_op == load_op::copy ? bandwidth_op::copy : bandwidth_op::triad;
+    const bandwidth* load = fastest_variant(op, m * (k-1), k-1);
+
+    if (!CSV) {
+      print_point(n*k*chase_stride, k, repeat, tries, cpus);
+      std::cout << std::endl;
+    }
+
+    for (float64_t intensity : intensities) {
+      bool stop = false;
+      float64_t latency_s = 0., total = 0.;
+      OMP(parallel firstprivate(n, m, repeat, tries, load)) {
+#ifdef _OPENMP
+        const bool chaser = omp_get_thread_num() == 0;
+#else
+        const bool chaser = true;
+#endif
+        void *buffer = allocate_or_abort(chaser ? n * chase_stride : m, 0x1000);
+        void *chain = nullptr;
+        if (chaser) {
+          chain = make_chain(buffer, n * chase_stride, chase_stride);
+        } else {
+          for (long long i = 0; i < m; ++i) static_cast<char*>(buffer)[i] = 0;
+        }
+        OMP(barrier);
+        if (chaser) {
+          // one walk to warm up (and let the traffic start), then the measure
+          chase_latency(chain, n, 1);
+          latency_s = chase_latency(chain, n * repeat, tries);
+          __atomic_store_n(&stop, true, __ATOMIC_RELAXED);
+        } else {
+          float64_t bw = generate_load(loaded_op, load, buffer, m, intensity, &stop);
+          OMP(atomic) total += bw;
+        }
+        OMP(barrier);
+        deallocate(buffer);
+      }
+
+      if (CSV) {
+        std::cout << "ptr," << static_cast<float64_t>(n*k*chase_stride) << ',' << load_op_name(loaded_op) << ',' << intensity << ',' << latency_s << ',' << total;
+        print_config_row(k, tries);
+      } else {
+        std::cout << "    intensity: " << std::setw(4) << 100. * intensity << "%";
+        std::cout << "  \tlatency: " << std::setw(6) << latency_s * 1e9 << " ns";
+        std::cout << "  \tbandwidth: " << std::setw(6) << bytes(total) << "/s";
+      }
+      std::cout << std::endl;
+    }
+  }
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bandwidth.h"
+#include "cli.h"
+#include "measure.h"
+#include "memops.h"
+#include "modes.h"
+#include "omp-helper.h"
+#include "stats.h"
+
+namespace {
+  // copies and fills of the C and C++ libraries and of rep movsb/stosb side by side with the best copy and
+  // write kernels, on the buffers of the copy (A and B halves) and write ops of test()
+  constexpr int nb_memops = 9;
+  const char* memops_names[nb_memops] = {"copy", "memcpy", "memmove", "movsb", "std::copy", "write", "memset", "stosb", "std::fill"};
+}
+
+template <class T>
+void test_memops(const std::vector<long long>& sizes, float64_t cost) {
+  const copy_impl copies[] = {copy_impl::memcpy, copy_impl::memmove, copy_impl::movsb, copy_impl::std_copy};
+  const fill_impl fills[] = {fill_impl::memset, fill_impl::stosb, fill_impl::std_fill};
+  // with the summary only, the sweep itself is not printed
+  const bool quiet = summary_only;
+  if (!quiet) {
+    std::string columns = "type,size";
+    for (int op = 0; op < nb_memops; ++op) columns += std::string(",") + memops_names[op];
+    print_header(columns, std::string("Testing copy and fill implementations with type: ") + name<T>());
+  }
+  std::vector<std::array<float64_t, nb_memops>> results;
+  std::cout << std::setprecision(3);
+
+  // narrowest kernel run: smaller buffers are skipped
+  int min_kern = 0;
+  for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
+    if (selected(b, sizeof(T), filter) && (min_kern == 0 || b->kern < min_kern)) min_kern = b->kern;
+  }
+  // the sizes measured
+  std::vector<point> points;
+  for (point p : sweep(sizes)) {
+    long long size = p.size;
+    int k = p.threads;
+    long long n = size / sizeof(T) / k;
+    if (n/2 < min_kern) continue;
+    points.push_back(p);
+    set_num_threads(k);
+    std::vector<int> cpus = pin_threads(k);
+
+    int repeat = 1;
+    int tries = 1;
+    get_repeat_tries(cost, n, repeat, tries);
+    long long tries_start = samples_total();
+
+    if (!quiet) {
+      if (CSV) {
+        std::cout << name<T>() << ',' << static_cast<float64_t>(n*k*sizeof(T));
+      } else {
+        print_point(n*k*sizeof(T), k, repeat, tries, cpus);
+        std::cout << std::flush;
+      }
+    }
+
+    std::array<float64_t, nb_memops> row = {};
+    // bandwidth of every variant of the copy and write kernels (to pick the fastest one)
+    std::vector<variant> copy_variants, write_variants;
+    OMP(parallel firstprivate(n, repeat, tries, k)) {
+      T *buffer = allocate_or_abort<T>(n + 0x3000 / sizeof(T), 0x1000);
+      for (long long i = 0; i < (long long)(n + 0x3000 / sizeof(T)); ++i) {
+        buffer[i] = 0;
+      }
+      buffers<T> x(buffer, n);
+      T *A1 = x.A1, *A2 = x.A2, *B2 = x.B2;
+
+      // each kernel processes a multiple of its width: the libraries get as many elements as the fastest one
+      std::array<float64_t, nb_memops> cur = {};
+      cur[0] = max_bandwidth<T>([A2, B2, n, repeat, tries](const bandwidth* b){ return b->copy(A2, B2, round_down(n/2, b->kern), repeat, tries); }, nullptr, &copy_variants);
+      OMP(barrier);
+      const long long n2 = round_down(n/2, fastest(copy_variants).kern);
+      for (int i = 0; i < 4; ++i) {
+        cur[1 + i] = copy_bandwidth(copies[i], A2, B2, n2 * sizeof(T), sizeof(T), repeat, tries);
+      }
+      cur[5] = max_bandwidth<T>([A1, n, repeat, tries](const bandwidth* b){ return b->write(A1, round_down(n, b->kern), repeat, tries); }, nullptr, &write_variants);
+      OMP(barrier);
+      const long long n1 = round_down(n, fastest(write_variants).kern);
+      for (int i = 0; i < 3; ++i) {
+        cur[6 + i] = fill_bandwidth(fills[i], A1, n1 * sizeof(T), sizeof(T), repeat, tries);
+      }
+      OMP(master) {
+        for (int op = 0; op < nb_memops; ++op) row[op] = k * std::max(cur[op], 0.);
+      }
+
+      deallocate(buffer);
+    }
+
+    long long tries_used = samples_total() - tries_start;
+    if (!quiet) {
+      if (CSV) {
+        for (int op = 0; op < nb_memops; ++op) std::cout << ',' << row[op];
+        print_config_row(k, tries_used);
+      } else {
+        for (int op = 0; op < nb_memops; ++op) {
+          if (op == 5) std::cout << " |";
+          std::cout << "  \t" << memops_names[op] << ": " << std::setw(6) << bytes(row[op]) << "/s";
+        }
+        if (verbose && adaptive.enabled) std::cout << "  \ttries: " << tries_used;
+      }
+      std::cout << std::endl;
+    }
+    results.push_back(row);
+  }
+
+  if (summary_only || !CSV) print_summary(name<T>(), points, results, memops_names);
+}
+
+#define INSTANTIATE(T) template void test_memops<T>(const std::vector<long long>& sizes, float64_t cost);
+FOR_EACH_TYPE(INSTANTIATE)
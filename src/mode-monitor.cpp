@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "allocation.h"
+#include "cli.h"
+#include "measure.h"
+#include "modes.h"
+#include "monitor.h"
+#include "omp-helper.h"
+#include "placement.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+static bool monitor_stop = false;
+
+extern "C" void stop_monitor(int) {
+  __atomic_store_n(&monitor_stop, true, __ATOMIC_RELAXED);
+}
+
+namespace {
+  // configuration measured by every run of the monitoring mode
+  struct probe {
+    std::string name;
+    std::vector<bandwidth_op> ops;
+    bandwidth_type type;
+    long long size; // bytes over all the threads
+    int threads;    // 0: every CPU (of the node)
+    int node;       // cpu and memory node (-1: any)
+  };
+
+  // the configurations of the former cron.sh ("numactl -N 0 -m 0 -C 0", "numactl -N 0 -m 0" and the whole machine,
+  // first type of the default output): the first CPU of node 0, every CPU of node 0 and every allowed CPU
+  std::vector<probe> default_probes() {
+    const std::vector<bandwidth_op> all = {bandwidth_op::read, bandwidth_op::write, bandwidth_op::copy, bandwidth_op::incr,
+                                           bandwidth_op::scale, bandwidth_op::add, bandwidth_op::triad};
+    std::vector<probe> probes(3);
+    probes[0] = {"1c", all, bandwidth_type::f32, 1ll << 30, 1, 0};
+    probes[1] = {"1s", all, bandwidth_type::f32, 4ll << 30, 0, 0};
+    probes[2] = {"2s", all, bandwidth_type::f32, 8ll << 30, 0, -1};
+    return probes;
+  }
+
+  // reads one probe per line: "name ops type size [threads [node]]", eg: "socket0 read,copy f64 4GiB 0 0"
+  // ("all" ops, '#' starts a comment)
+  bool read_probes(const char* path, std::vector<probe>& probes) {
+    if (std::strcmp(path, "default") == 0) {
+      probes = default_probes();
+      return true;
+    }
+    std::ifstream file(path);
+    if (!file) {
+      std::cerr << "error: cannot read the probes of \"" << path << "\"\n";
+      return false;
+    }
+    probes.clear();
+    std::string line;
+    for (int lineno = 1; std::getline(file, line); ++lineno) {
+      line = line.substr(0, line.find('#'));
+      std::istringstream in(line);
+      probe p;
+      std::string ops, type, size;
+      if (!(in >> p.name)) continue;
+      if (!(in >> ops >> type >> size)) {
+        std::cerr << "error: " << path << ':' << lineno << ": a probe should be \"name ops type size [threads [node]]\"\n";
+        return false;
+      }
+      if (!(in >> p.threads)) p.threads = 0;
+      if (!(in >> p.node)) p.node = -1;
+      std::istringstream op_list(ops);
+      std::string word;
+      while (std::getline(op_list, word, ',')) {
+        bool found = false;
+        for (int op = 0; op < nb_ops; ++op) {
+          if (word != "all" && word != op_names[op]) continue;
+          p.ops.push_back(static_cast<bandwidth_op>(op));
+          found = true;
+        }
+        if (!found) {
+          std::cerr << "error: " << path << ':' << lineno << ": unknown op \"" << word << "\"\n";
+          return false;
+        }
+      }
+      std::vector<bandwidth_type> t;
+      if (!parse_types(type.c_str(), t) || t.size() != 1) {
+        std::cerr << "error: " << path << ':' << lineno << ": a probe should have one type\n";
+        return false;
+      }
+      p.type = t.front();
+      p.size = bytes(size.c_str());
+      if (p.size <= 0 || p.threads < 0) {
+        std::cerr << "error: " << path << ':' << lineno << ": invalid size or thread count\n";
+        return false;
+      }
+      probes.push_back(p);
+    }
+    if (probes.empty()) {
+      std::cerr << "error: no probe in \"" << path << "\"\n";
+      return false;
+    }
+    return true;
+  }
+
+  // reports a drop below the baseline: runs the alert command with the details in its environment
+  void alert(const std::string& host, const probe& p, bandwidth_op op, float64_t bandwidth, float64_t base) {
+    std::cerr << std::setprecision(3) << "Warning: " << host << ": probe " << p.name << ' ' << op_name(op) << ": " << bytes(bandwidth) << "/s";
+    std::cerr << " is " << 100. * (1. - bandwidth / base) << "% below the baseline (" << bytes(base) << "/s)" << std::endl;
+    if (monitor_alert.empty() || monitor_alert == "exit") return;
+    setenv("BANDWIDTH_HOST", host.c_str(), 1);
+    setenv("BANDWIDTH_PROBE", p.name.c_str(), 1);
+    setenv("BANDWIDTH_OP", op_name(op), 1);
+    setenv("BANDWIDTH_VALUE", std::to_string(bandwidth).c_str(), 1);
+    setenv("BANDWIDTH_BASELINE", std::to_string(base).c_str(), 1);
+    if (std::system(monitor_alert.c_str()) != 0) {
+      std::cerr << "Warning: The alert command failed: " << monitor_alert << std::endl;
+    }
+  }
+}
+
+// measures the probes every "monitor_interval" seconds (once if 0), appends the results to the history file
+// and compares them with the baseline of the host; returns the exit status (2: drop with "--alert exit")
+int run_monitor(float64_t cost) {
+  std::vector<probe> probes;
+  if (!read_probes(monitor_probes, probes)) return 1;
+  if (!(monitor_threshold > 0. && monitor_threshold < 1.)) {
+    std::cerr << "error: the threshold (" << monitor_threshold << ") should be between 0 and 100%" << std::endl;
+    return 1;
+  }
+  const std::string host = host_name();
+  const std::string baseline_path = monitor_history + "." + host + ".baseline";
+  const std::string header = "time,host,probe,op,type,size,threads,node,bandwidth,baseline,ratio,status";
+  baseline base;
+  if (!load_baseline(baseline_path, base)) {
+    std::cerr << "error: cannot parse the baseline \"" << baseline_path << "\"" << std::endl;
+    return 1;
+  }
+  std::signal(SIGINT, stop_monitor);
+  std::signal(SIGTERM, stop_monitor);
+
+  std::cout << std::setprecision(3);
+  if (CSV) {
+    std::cout << header << std::endl;
+  } else {
+    std::cout << "Monitoring " << host << ": " << probes.size() << " probes";
+    if (monitor_interval > 0.) std::cout << " every " << monitor_interval << " s";
+    std::cout << "  threshold: " << 100. * monitor_threshold << "%  history: " << monitor_history << std::endl;
+  }
+
+  measure_options options;
+  options.cost = cost;
+  options.variants = filter;
+  bool bound = false;
+  for (;;) {
+    auto start = std::chrono::steady_clock::now();
+    const std::string time = utc_time();
+    std::vector<std::string> rows;
+    int drops = 0;
+    if (!CSV) std::cout << "  " << time << std::endl;
+    for (const probe& p : probes) {
+      if (__atomic_load_n(&monitor_stop, __ATOMIC_RELAXED)) break;
+      int k = p.threads;
+      if (p.node >= 0) {
+        bind_threads({p.node});
+        set_mem_policy(mem_policy::bind, {p.node});
+        const std::vector<int> node_cpus = numa_node_cpus(p.node);
+        if (k == 0) k = node_cpus.size();
+        // fewer threads than CPUs: one thread per CPU from the first one of the node (numactl -C 0 for "1c")
+        if (k < (int) node_cpus.size()) {
+          set_num_threads(k);
+          OMP(parallel) {
+#ifdef _OPENMP
+            int id = omp_get_thread_num();
+#else
+            int id = 0;
+#endif
+            bind_thread({node_cpus[id]});
+          }
+        }
+      } else if (bound) {
+        bind_threads(numa_cpu_nodes());
+        set_mem_policy(mem_policy::local);
+      }
+      bound = p.node >= 0;
+      if (k <= 0) k = max_threads;
+      for (bandwidth_op op : p.ops) {
+        measure_result r = measure(op, p.type, p.size, k, options);
+        baseline_entry& e = base[p.name + ":" + op_name(op)];
+        const char* status = "ok";
+        float64_t ratio = e.bandwidth > 0. ? r.bandwidth / e.bandwidth : 1.;
+        if (e.runs < baseline_runs) {
+          // the baseline is the best of the first runs
+          status = "baseline";
+          if (r.bandwidth > 0.) {
+            e.bandwidth = std::max(e.bandwidth, r.bandwidth);
+            ++e.runs;
+          }
+        } else if (r.bandwidth <= 0.) {
+          status = "failed";
+          ++drops;
+          std::cerr << "Warning: " << host << ": probe " << p.name << ' ' << op_name(op) << " failed" << std::endl;
+        } else if (ratio < 1. - monitor_threshold) {
+          status = "drop";
+          ++drops;
+          alert(host, p, op, r.bandwidth, e.bandwidth);
+        }
+        std::ostringstream row;
+        row << time << ',' << host << ',' << p.name << ',' << op_name(op) << ',' << type_name(p.type) << ',' << p.size;
+        row << ',' << k << ',' << p.node << ',' << r.bandwidth << ',' << e.bandwidth << ',' << ratio << ',' << status;
+        rows.push_back(row.str());
+        if (CSV) {
+          std::cout << rows.back() << std::endl;
+        } else {
+          std::cout << "    probe: " << std::setw(8) << p.name << "  op: " << std::setw(5) << op_name(op);
+          std::cout << "  \tbandwidth: " << std::setw(6) << bytes(r.bandwidth) << "/s  \tbaseline: " << std::setw(6) << bytes(e.bandwidth) << "/s";
+          std::cout << "  \tratio: " << std::setw(5) << 100. * ratio << "%  \t" << status << std::endl;
+        }
+      }
+    }
+    if (!save_baseline(baseline_path, base)) {
+      std::cerr << "Warning: Failed to write the baseline \"" << baseline_path << "\"" << std::endl;
+    }
+    if (!append_history(monitor_history, header, rows)) {
+      std::cerr << "Warning: Failed to write the history \"" << monitor_history << "\"" << std::endl;
+    }
+    if (drops > 0 && monitor_alert == "exit") return 2;
+    if (monitor_interval <= 0.) break;
+    // short sleeps: a signal stops the monitor without waiting for the next run
+    auto next = start + std::chrono::duration<float64_t>(monitor_interval);
+    while (std::chrono::steady_clock::now() < next && !__atomic_load_n(&monitor_stop, __ATOMIC_RELAXED)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (__atomic_load_n(&monitor_stop, __ATOMIC_RELAXED)) break;
+  }
+  return 0;
+}
+
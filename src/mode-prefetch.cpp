@@ -0,0 +1,126 @@
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bandwidth.h"
+#include "cli.h"
+#include "measure.h"
+#include "modes.h"
+#include "omp-helper.h"
+#include "stats.h"
+
+// sweeps the distance of the software prefetches of every hint, and compares the best one
+// with the same kernel relying on the hardware prefetchers only
+template <class T>
+void test_prefetch(const std::vector<long long>& sizes, float64_t cost) {
+  const int hints[] = {prefetch_t0, prefetch_t1, prefetch_t2, prefetch_nta};
+  print_header("type,size,op,hint,distance,bandwidth,best", std::string("Testing software prefetch with type: ") + name<T>());
+  std::cout << std::setprecision(3);
+
+  for (point p : sweep(sizes)) {
+    long long size = p.size;
+    int k = p.threads;
+    set_num_threads(k);
+    std::vector<int> cpus = pin_threads(k);
+
+    long long n = size / sizeof(T) / k;
+    int repeat = 1;
+    int tries = 1;
+    get_repeat_tries(cost, n, repeat, tries);
+    long long tries_start = samples_total();
+
+    if (!CSV) {
+      print_point(n*k*sizeof(T), k, repeat, tries, cpus);
+      std::cout << std::endl;
+    }
+
+    // [op][hint][distance] (bandwidth of one thread), and the baseline of every op
+    std::vector<std::vector<std::vector<float64_t>>> grid(nb_ops, std::vector<std::vector<float64_t>>(4, std::vector<float64_t>(prefetch_distances.size())));
+    std::array<float64_t, nb_ops> baseline = {};
+    OMP(parallel firstprivate(n, repeat, tries)) {
+      T *buffer = allocate_or_abort<T>(n + 0x3000 / sizeof(T), 0x1000);
+      for (long long i = 0; i < (long long)(n + 0x3000 / sizeof(T)); ++i) {
+        buffer[i] = 0;
+      }
+      buffers<T> x(buffer, n);
+
+      // the prefetch kernels are compared with the kernel of the same width with temporal stores
+      const bandwidth* plain = nullptr;
+      for (const bandwidth* b = bandwidth_benches; b->kern != 0; ++b) {
+        if (b->kern == prefetch_benches->kern && !b->nontemporal) plain = b;
+      }
+      int count = 1;
+      for (const prefetch_bandwidth* pb = prefetch_benches; pb->kern != 0; ++pb) count += prefetch_distances.size();
+
+      for (int op = 0; op < nb_ops; ++op) {
+        const bandwidth_op o = static_cast<bandwidth_op>(op);
+        // the baseline, hints and distances share the adaptive budget of the op
+        OMP(master) samples_budget_split(count);
+        float64_t base = run_op<T>(plain, o, x, n, repeat, tries);
+        OMP(master) baseline[op] = base;
+        for (const prefetch_bandwidth* pb = prefetch_benches; pb->kern != 0; ++pb) {
+          for (unsigned d = 0; d < prefetch_distances.size(); ++d) {
+            float64_t cur = run_op<T>(pb, o, x, n, prefetch_distances[d] / static_cast<long long>(sizeof(T)), repeat, tries);
+            OMP(master) grid[op][pb->hint][d] = cur;
+          }
+        }
+      }
+
+      deallocate(buffer);
+    }
+
+    // tries run for this point (every op, hint and distance)
+    long long tries_used = samples_total() - tries_start;
+    for (int op = 0; op < nb_ops; ++op) {
+      int best_hint = -1;
+      unsigned best_d = 0;
+      float64_t best = baseline[op];
+      for (int hint : hints) {
+        for (unsigned d = 0; d < prefetch_distances.size(); ++d) {
+          if (grid[op][hint][d] > best) {
+            best = grid[op][hint][d];
+            best_hint = hint;
+            best_d = d;
+          }
+        }
+      }
+      if (CSV) {
+        std::cout << name<T>() << ',' << static_cast<float64_t>(n*k*sizeof(T)) << ',' << op_names[op] << ",none,0," << static_cast<float64_t>(k * baseline[op]) << ',' << (best_hint < 0);
+        print_config_row(k, tries_used);
+        std::cout << std::endl;
+        for (int hint : hints) {
+          for (unsigned d = 0; d < prefetch_distances.size(); ++d) {
+            std::cout << name<T>() << ',' << static_cast<float64_t>(n*k*sizeof(T)) << ',' << op_names[op] << ',' << hint_name(hint) << ',' << prefetch_distances[d];
+            std::cout << ',' << static_cast<float64_t>(k * grid[op][hint][d]) << ',' << (hint == best_hint && d == best_d);
+            print_config_row(k, tries_used);
+            std::cout << std::endl;
+          }
+        }
+      } else {
+        std::cout << "    " << std::setw(6) << std::left << op_names[op] << std::right;
+        std::cout << "  	none: " << std::setw(6) << bytes(k * baseline[op]) << "/s";
+        if (best_hint < 0) {
+          std::cout << "  	best: none";
+        } else {
+          std::cout << "  	best: " << std::setw(3) << hint_name(best_hint) << " at " << std::setw(6) << bytes(prefetch_distances[best_d]);
+          std::cout << ": " << std::setw(6) << bytes(k * best) << "/s (+" << 100. * (best / baseline[op] - 1.) << "%)";
+        }
+        std::cout << std::endl;
+        if (show_variants) {
+          for (int hint : hints) {
+            std::cout << "      " << std::setw(4) << std::left << hint_name(hint) << std::right;
+            for (unsigned d = 0; d < prefetch_distances.size(); ++d) {
+              std::cout << "  	" << std::setw(6) << bytes(prefetch_distances[d]) << ": " << std::setw(6) << bytes(k * grid[op][hint][d]) << "/s";
+            }
+            std::cout << std::endl;
+          }
+        }
+      }
+    }
+    if (!CSV && verbose && adaptive.enabled) std::cout << "    tries: " << tries_used << std::endl;
+  }
+}
+
+#define INSTANTIATE(T) template void test_prefetch<T>(const std::vector<long long>& sizes, float64_t cost);
+FOR_EACH_TYPE(INSTANTIATE)
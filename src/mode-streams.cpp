@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "bandwidth.h"
+#include "cli.h"
+#include "measure.h"
+#include "modes.h"
+#include "omp-helper.h"
+#include "stats.h"
+
+// reads (and writes) "count" concurrent arrays for every count of stream_counts, to find how many streams
+// the hardware prefetchers and the DRAM banks sustain
+template <class T>
+void test_streams(const std::vector<long long>& sizes, float64_t cost) {
+  std::ostringstream title;
+  title << "Testing concurrent streams with type: " << name<T>() << " (offset: " << bytes(stream_offset) << ")";
+  print_header("type,size,streams,offset,read,write", title.str());
+  std::cout << std::setprecision(3);
+
+  const long long offset = stream_offset / sizeof(T);
+  const int max_count = *std::max_element(stream_counts.begin(), stream_counts.end());
+  for (point p : sweep(sizes)) {
+    long long size = p.size;
+    int k = p.threads;
+    set_num_threads(k);
+    std::vector<int> cpus = pin_threads(k);
+
+    long long n = size / sizeof(T) / k;
+    int repeat = 1;
+    int tries = 1;
+    get_repeat_tries(cost, n, repeat, tries);
+
+    for (int count : stream_counts) {
+      // elements per array (page aligned when possible), and distance between two arrays
+      long long m = n / count >= 0x1000 / (long long) sizeof(T) ? round_down(n / count, 0x1000 / sizeof(T)) : round_down(n / count, 64 / sizeof(T));
+      long long s = m + offset;
+      if (m < 1) continue;
+      long long tries_start = samples_total();
+
+      if (CSV) {
+        std::cout << name<T>() << ',' << static_cast<float64_t>(n*k*sizeof(T)) << ',' << count << ',' << stream_offset;
+      } else {
+        std::ostringstream details;
+        details << "  streams: " << std::setw(3) << count;
+        print_point(n*k*sizeof(T), k, repeat, tries, cpus, details.str());
+        std::cout << std::flush;
+      }
+
+      float64_t read_b = 0., write_b = 0.;
+      OMP(parallel firstprivate(n, m, s, repeat, tries)) {
+        long long total = n + max_count * (offset + 0x1000 / sizeof(T));
+        T *buffer = allocate_or_abort<T>(total, 0x1000);
+        for (long long i = 0; i < total; ++i) {
+          buffer[i] = 0;
+        }
+        // count:0 and 0:count mixes (without the arrays they do not access)
+        float64_t r = max_bandwidth<T>([buffer, m, s, count, repeat, tries](const bandwidth* b){ return b->mix(buffer, nullptr, round_down(m, b->kern), s, count, 0, repeat, tries); });
+        float64_t w = max_bandwidth<T>([buffer, m, s, count, repeat, tries](const bandwidth* b){ return b->mix(nullptr, buffer, round_down(m, b->kern), s, 0, count, repeat, tries); });
+        OMP(master) {
+          read_b = k * r;
+          write_b = k * w;
+        }
+        deallocate(buffer);
+      }
+
+      long long tries_used = samples_total() - tries_start;
+      if (CSV) {
+        std::cout << ',' << read_b << ',' << write_b;
+        print_config_row(k, tries_used);
+      } else {
+        std::cout << "  \tread: " << std::setw(6) << bytes(read_b) << "/s";
+        std::cout << "  \twrite: " << std::setw(6) << bytes(write_b) << "/s";
+        if (verbose && adaptive.enabled) std::cout << "  \ttries: " << tries_used;
+      }
+      std::cout << std::endl;
+    }
+  }
+}
+
+#define INSTANTIATE(T) template void test_streams<T>(const std::vector<long long>& sizes, float64_t cost);
+FOR_EACH_TYPE(INSTANTIATE)
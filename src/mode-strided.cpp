@@ -0,0 +1,112 @@
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "cli.h"
+#include "measure.h"
+#include "modes.h"
+#include "omp-helper.h"
+#include "stats.h"
+#include "strided.h"
+
+namespace {
+  // strides (in bytes) run with elements of "elem_size" bytes
+  std::vector<long long> element_strides(int elem_size, const char* type) {
+    std::vector<long long> r;
+    if (strides.size() == 1 && strides[0] == 0) {
+      // auto: every power of two from one element to a page
+      for (long long s = elem_size; s <= 4096; s *= 2) r.push_back(s);
+      return r;
+    }
+    for (long long s : strides) {
+      if (s > 0 && s % elem_size == 0) {
+        r.push_back(s);
+      } else {
+        std::cerr << "Warning: stride " << s << " B skipped with type " << type << " (not a multiple of " << elem_size << " B)" << std::endl;
+      }
+    }
+    return r;
+  }
+}
+
+// accesses one element every "stride" bytes: useful bytes per second and cache lines per second
+template <class T>
+void test_strided(const std::vector<long long>& sizes, float64_t cost) {
+  const int nb_strided = 3;
+  const char* strided_names[nb_strided] = {"read", "write", "copy"};
+  print_header("type,size,stride,read,write,copy,read_lines,write_lines,copy_lines", std::string("Testing strided accesses with type: ") + name<T>());
+  std::cout << std::setprecision(3);
+
+  const std::vector<long long> type_strides = element_strides(sizeof(T), name<T>());
+  for (point p : sweep(sizes)) {
+    long long size = p.size;
+    int k = p.threads;
+    set_num_threads(k);
+    std::vector<int> cpus = pin_threads(k);
+
+    // bytes per thread
+    long long m = round_down(size / k, sizeof(T));
+    for (long long stride : type_strides) {
+      // accesses per thread (copy: half the buffer each for A and B)
+      long long n = m / stride;
+      long long n2 = m / 2 / stride;
+      if (n < 1) continue;
+      int repeat = 1;
+      int tries = 1;
+      get_repeat_tries(cost, n, repeat, tries);
+      long long tries_start = samples_total();
+
+      if (CSV) {
+        std::cout << name<T>() << ',' << static_cast<float64_t>(m*k) << ',' << stride;
+      } else {
+        std::ostringstream details;
+        details << std::setprecision(3) << "  stride: " << std::setw(6) << bytes(stride);
+        print_point(m*k, k, repeat, tries, cpus, details.str());
+        std::cout << std::flush;
+      }
+
+      // useful bytes per second and cache lines per second (over all the threads)
+      std::array<float64_t, nb_strided> useful = {}, lines = {};
+      OMP(parallel firstprivate(n, n2, repeat, tries)) {
+        char *buffer = allocate_or_abort<char>(m + 0x2000, 0x1000);
+        for (long long i = 0; i < m + 0x2000; ++i) {
+          buffer[i] = 0;
+        }
+        char *A = buffer;
+        char *B = reinterpret_cast<char*>(round_up(reinterpret_cast<unsigned long long>(A + m/2), 0x1000));
+
+        float64_t read_b = strided_read(A, sizeof(T), stride, n, repeat, tries);
+        float64_t write_b = strided_write(A, sizeof(T), stride, n, repeat, tries);
+        float64_t copy_b = strided_copy(A, B, sizeof(T), stride, n2, repeat, tries);
+        OMP(master) {
+          // bytes/s -> accesses/s -> lines/s
+          useful = {k * read_b, k * write_b, k * copy_b};
+          lines[0] = useful[0] / (n * sizeof(T)) * strided_lines(stride, n);
+          lines[1] = useful[1] / (n * sizeof(T)) * strided_lines(stride, n);
+          lines[2] = useful[2] / (2 * n2 * sizeof(T)) * 2 * strided_lines(stride, n2);
+        }
+
+        deallocate(buffer);
+      }
+
+      long long tries_used = samples_total() - tries_start;
+      if (CSV) {
+        for (int op = 0; op < nb_strided; ++op) std::cout << ',' << useful[op];
+        for (int op = 0; op < nb_strided; ++op) std::cout << ',' << lines[op];
+        print_config_row(k, tries_used);
+      } else {
+        for (int op = 0; op < nb_strided; ++op) {
+          std::cout << "  \t" << strided_names[op] << ": " << std::setw(6) << bytes(useful[op]) << "/s " << std::setw(6) << lines[op] * 1e-9 << " Gl/s";
+        }
+        if (verbose && adaptive.enabled) std::cout << "  \ttries: " << tries_used;
+      }
+      std::cout << std::endl;
+    }
+  }
+}
+
+
+#define INSTANTIATE(T) template void test_strided<T>(const std::vector<long long>& sizes, float64_t cost);
+FOR_EACH_TYPE(INSTANTIATE)
@@ -0,0 +1,304 @@
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bandwidth.h"
+#include "cli.h"
+#include "counters.h"
+#include "measure.h"
+#include "modes.h"
+#include "omp-helper.h"
+#include "placement.h"
+#include "stats.h"
+
+namespace {
+  // prints what the hardware counters saw for each op, per byte and cache line moved by one pass of the op
+  // (the counts and the bandwidth come from the same try, the fastest one; the core cycles are counted by every
+  // thread during its timed region: the actual frequency of the cores is their average over the threads,
+  // whatever the rate of the timer)
+  void print_counters(long long n, int elem_size, int threads, const std::array<float64_t, nb_ops>& row, const std::array<counts, nb_ops>& events) {
+    for (int op = 0; op < nb_ops; ++op) {
+      // bytes moved by one pass of the op (as in its bandwidth), and their cache lines
+      const float64_t size = static_cast<float64_t>(threads) * op_bytes(static_cast<bandwidth_op>(op), n, elem_size);
+      const float64_t lines = size / 64.;
+      const float64_t* v = events[op].value;
+      std::cout << "    " << std::setw(6) << std::left << op_names[op] << std::right;
+      if (v[ev_cycles] > 0.) {
+        std::cout << "  \t" << std::setw(6) << size / v[ev_cycles] << " B/cycle";
+        if (row[op] > 0.) std::cout << "  \t" << std::setw(6) << v[ev_cycles] / threads * row[op] / size * 1e-9 << " GHz";
+        if (v[ev_instructions] >= 0.) std::cout << "  \tIPC: " << std::setw(6) << v[ev_instructions] / v[ev_cycles];
+      }
+      if (v[ev_l1d_misses] >= 0.) std::cout << "  \tL1D misses: " << std::setw(6) << v[ev_l1d_misses] / lines << "/line";
+      if (v[ev_llc_misses] >= 0.) std::cout << "  \tLLC misses: " << std::setw(6) << v[ev_llc_misses] / lines << "/line";
+      if (v[ev_dtlb_misses] >= 0.) std::cout << "  \tdTLB misses: " << std::setw(6) << v[ev_dtlb_misses] / lines << "/line";
+      if (v[ev_dram_reads] >= 0. && v[ev_dram_writes] >= 0.) {
+        // every CAS moves a cache line
+        float64_t dram = 64. * (v[ev_dram_reads] + v[ev_dram_writes]);
+        std::cout << "  \tDRAM: " << std::setw(6) << bytes(row[op] * dram / size) << "/s (reads: " << 64. * v[ev_dram_reads] / size;
+        std::cout << ", writes: " << 64. * v[ev_dram_writes] / size << " B per B)";
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  // prints the bandwidth of every variant of every op then of every mix, and the fastest one
+  // (with the tries of each variant)
+  void print_variants(const char* type, float64_t size, int threads, const std::vector<std::vector<variant>>& variants) {
+    for (unsigned op = 0; op < variants.size(); ++op) {
+      const std::vector<variant>& vs = variants[op];
+      if (vs.empty()) continue;
+      const std::string op_name = op < nb_ops ? op_names[op] : mix_name(mixes[op - nb_ops]);
+      unsigned best = 0;
+      for (unsigned i = 1; i < vs.size(); ++i) {
+        if (vs[i].bandwidth > vs[best].bandwidth) best = i;
+      }
+      if (CSV) {
+        for (unsigned i = 0; i < vs.size(); ++i) {
+          std::cout << type << ',' << size << ',' << op_name << ',' << vs[i].kern << ',' << vs[i].nontemporal;
+          std::cout << ',' << static_cast<float64_t>(threads * vs[i].bandwidth) << ',' << (i == best);
+          print_config_row(threads, vs[i].tries);
+          std::cout << std::endl;
+        }
+      } else {
+        std::cout << "    " << std::setw(6) << std::left << op_name << std::right;
+        for (const variant& v : vs) {
+          std::cout << "  \t" << std::setw(3) << v.kern << (v.nontemporal ? " nt: " : "  t: ") << std::setw(6) << bytes(threads * v.bandwidth) << "/s";
+        }
+        std::cout << "  \tbest: " << vs[best].kern << (vs[best].nontemporal ? " nt" : " t");
+        if (verbose && adaptive.enabled) {
+          long long tries = 0;
+          for (const variant& v : vs) tries += v.tries;
+          std::cout << "  \ttries: " << tries;
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+
+  // measures every op at each point, and prints them unless "quiet"
+  template <class T>
+  std::vector<std::array<float64_t, nb_ops>> test(const std::vector<point>& points, float64_t cost, bool quiet) {
+    if (!quiet) {
+      std::string columns = "type,size,op,kern,nontemporal,bandwidth,best", tries = ",tries";
+      if (!show_variants) {
+        // tries of every op (every variant of the op)
+        columns = "type,size,read,write,copy,incr,scale,add,triad";
+        tries.clear();
+        for (const char* op : op_names) tries += std::string(",") + op + "_tries";
+        for (std::pair<int, int> mix : mixes) {
+          columns += ',' + mix_name(mix);
+          tries += ',' + mix_name(mix) + "_tries";
+        }
+      }
+      print_header(columns, std::string("Testing bandwidth with type: ") + name<T>(), tries);
+    }
+    std::vector<std::array<float64_t, nb_ops>> results;
+    std::cout << std::setprecision(3);
+
+    for (point p : points) {
+      long long size = p.size;
+      int k = p.threads;
+      set_num_threads(k);
+      std::vector<int> cpus = pin_threads(k);
+
+      long long n = size / sizeof(T) / k;
+      int repeat = 1;
+      int tries = 1;
+      get_repeat_tries(cost, n, repeat, tries);
+
+      if (!quiet) {
+        if (CSV) {
+          if (!show_variants) std::cout << name<T>() << ',' << static_cast<float64_t>(n*k*sizeof(T));
+        } else {
+          print_point(n*k*sizeof(T), k, repeat, tries, cpus);
+          std::cout << std::flush;
+        }
+      }
+
+      std::array<float64_t, nb_ops> row = {};
+      // every op, then every mix
+      std::vector<std::vector<variant>> variants(nb_ops + mixes.size());
+      std::array<counts, nb_ops> events = {};
+      // tries run for every op, then every mix
+      std::vector<long long> op_tries(nb_ops + mixes.size());
+      OMP(parallel firstprivate(n, repeat, tries, k)) {
+        T *buffer = allocate_or_abort<T>(n + 0x3000 / sizeof(T), 0x1000);
+        for (long long i = 0; i < (long long)(n + 0x3000 / sizeof(T)); ++i) {
+          buffer[i] = 0;
+        }
+        buffers<T> x(buffer, n);
+
+        for (int op = 0; op < nb_ops; ++op) {
+          long long tries_start = 0;
+          OMP(master) tries_start = samples_total();
+          std::vector<float64_t> op_t;
+          float64_t op_b = k*max_bandwidth<T>([&x, op, n, repeat, tries](const bandwidth* b){ return run_op<T>(b, static_cast<bandwidth_op>(op), x, n, repeat, tries); }, &op_t, &variants[op], &events[op]);
+          OMP(master) {
+            row[op] = op_b;
+            op_tries[op] = samples_total() - tries_start;
+            print_stats(name<T>(), n*k*sizeof(T), k, op_names[op], op_b, op_t, events[op]);
+            if (!quiet) {
+              if (CSV) {
+                if (!show_variants) std::cout << ',' << static_cast<float64_t>(op_b);
+              } else {
+                std::cout << "  \t" << op_names[op] << ": " << std::setw(6) << bytes(op_b) << "/s";
+                if (verbose && adaptive.enabled && !show_variants) std::cout << " (" << op_tries[op] << " tries)";
+                std::cout << std::flush;
+              }
+            }
+          }
+        }
+
+        // k:w mixes: k + w arrays of s elements each
+        for (unsigned m = 0; m < mixes.size(); ++m) {
+          const std::pair<int, int> mix = mixes[m];
+          const int mk = mix.first, mw = mix.second;
+          long long tries_start = 0;
+          OMP(master) tries_start = samples_total();
+          const long long s = round_down(n / (mk + mw), 64 / sizeof(T));
+          T *A = buffer, *B = buffer + mk * s;
+          std::vector<float64_t> mix_t;
+          counts mix_events = {};
+          float64_t mix_b = k*max_bandwidth<T>([A, B, s, mk, mw, repeat, tries](const bandwidth* b){ return b->mix(A, B, round_down(s, b->kern), s, mk, mw, repeat, tries); }, &mix_t, &variants[nb_ops + m], &mix_events);
+          OMP(master) {
+            op_tries[nb_ops + m] = samples_total() - tries_start;
+            print_stats(name<T>(), n*k*sizeof(T), k, mix_name(mix).c_str(), mix_b, mix_t, mix_events);
+            if (!quiet) {
+              if (CSV) {
+                if (!show_variants) std::cout << ',' << static_cast<float64_t>(mix_b);
+              } else {
+                std::cout << "  \t" << mix_name(mix) << ": " << std::setw(6) << bytes(mix_b) << "/s";
+                if (verbose && adaptive.enabled) std::cout << " (" << op_tries[nb_ops + m] << " tries)";
+                std::cout << std::flush;
+              }
+            }
+          }
+        }
+
+        deallocate(buffer);
+      }
+
+      if (!quiet) {
+        if (show_variants) {
+          if (!CSV) std::cout << std::endl;
+          print_variants(name<T>(), n*k*sizeof(T), k, variants);
+        } else {
+          if (CSV) {
+            print_config_row(k, 0, false);
+            if (adaptive.enabled) {
+              for (long long t : op_tries) std::cout << ',' << t;
+            }
+          }
+          std::cout << std::endl;
+        }
+      }
+      if (counters_enabled && !CSV && !quiet) print_counters(n, sizeof(T), k, row, events);
+      results.push_back(row);
+    }
+
+    if (!numa_matrix && (summary_only || !CSV)) print_summary(name<T>(), points, results, op_names);
+    return results;
+  }
+
+  // the sweep with each page policy, then the share of the time the pages of the first policy lose to the
+  // TLB against the other ones (1 - bandwidth / bandwidth with the other pages)
+  template <class T>
+  void test_pages(const std::vector<long long>& sizes, float64_t cost) {
+    std::vector<std::vector<std::array<float64_t, nb_ops>>> results;
+    for (page_policy pages : page_policies) {
+      set_page_policy(pages);
+      // with the summary only, the sweep itself is not printed
+      results.push_back(test<T>(sweep(sizes), cost, summary_only));
+    }
+    if (CSV) return;
+    const std::vector<point> points = sweep(sizes);
+    const char* reference = page_policy_name(page_policies.front());
+    for (unsigned i = 1; i < page_policies.size(); ++i) {
+      std::cout << "TLB overhead with type: " << name<T>() << " (time lost with " << reference << " pages against " << page_policy_name(page_policies[i]) << ")" << std::endl;
+      for (unsigned j = 0; j < points.size() && j < results[0].size() && j < results[i].size(); ++j) {
+        std::cout << "  size: " << std::setw(6) << bytes(points[j].size);
+        if (!thread_counts.empty()) std::cout << "  threads: " << std::setw(3) << points[j].threads;
+        for (int op = 0; op < nb_ops; ++op) {
+          std::cout << "  \t" << op_names[op] << ": ";
+          if (results[0][j][op] > 0. && results[i][j][op] > 0.) {
+            std::cout << std::setw(5) << 100. * (1. - results[0][j][op] / results[i][j][op]) << "%";
+          } else {
+            std::cout << std::setw(6) << "-";
+          }
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+
+  // bandwidth of the largest size (and the last thread count) for each (cpu node, memory node) pair
+  template <class T>
+  void test_numa_matrix(const std::vector<long long>& sizes, float64_t cost) {
+    std::vector<int> cpu_nodes = numa_cpu_nodes(), mem_nodes = numa_nodes();
+    const point p = sweep(sizes).back();
+    std::vector<std::vector<std::array<float64_t, nb_ops>>> matrix(cpu_nodes.size(), std::vector<std::array<float64_t, nb_ops>>(mem_nodes.size()));
+
+    // placement of -N, -b and -I, restored afterwards
+    const std::vector<int> cpus = allowed_cpus;
+    const mem_policy policy = get_mem_policy();
+    const std::vector<int> nodes = get_mem_nodes();
+    for (unsigned i = 0; i < cpu_nodes.size(); ++i) {
+      bind_threads({cpu_nodes[i]});
+      for (unsigned j = 0; j < mem_nodes.size(); ++j) {
+        set_mem_policy(mem_policy::bind, {mem_nodes[j]});
+        matrix[i][j] = test<T>({p}, cost, true).back();
+      }
+    }
+    set_mem_policy(policy, nodes);
+    restore_threads(cpus);
+
+    print_header("type,size,read,write,copy,incr,scale,add,triad", std::string("Bandwidth matrix with type: ") + name<T>(), "");
+    if (CSV) {
+      for (unsigned i = 0; i < cpu_nodes.size(); ++i) {
+        for (unsigned j = 0; j < mem_nodes.size(); ++j) {
+          current_cpu_node = cpu_nodes[i];
+          current_mem_node = mem_nodes[j];
+          std::cout << name<T>() << ',' << static_cast<float64_t>(p.size);
+          for (int op = 0; op < nb_ops; ++op) std::cout << ',' << matrix[i][j][op];
+          print_config_row(p.threads, 0, false);
+          std::cout << std::endl;
+        }
+      }
+      current_cpu_node = current_mem_node = -1;
+      return;
+    }
+    std::cout << "  size: " << std::setw(6) << bytes(p.size);
+    if (!thread_counts.empty()) std::cout << "  threads: " << std::setw(3) << p.threads;
+    std::cout << "  (rows: cpu node, columns: memory node)" << std::endl;
+    for (int op = 0; op < nb_ops; ++op) {
+      std::cout << "  " << std::setw(6) << std::left << op_names[op] << std::right;
+      for (int node : mem_nodes) {
+        std::cout << "  \t   mem " << std::setw(2) << node;
+      }
+      std::cout << std::endl;
+      for (unsigned i = 0; i < cpu_nodes.size(); ++i) {
+        std::cout << "  cpu " << std::setw(2) << cpu_nodes[i];
+        for (unsigned j = 0; j < mem_nodes.size(); ++j) {
+          std::cout << "  \t" << std::setw(6) << bytes(matrix[i][j][op]) << "/s";
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+}
+
+template <class T>
+void test_sweep(const std::vector<long long>& sizes, float64_t cost) {
+  if (numa_matrix) {
+    test_numa_matrix<T>(sizes, cost);
+  } else if (page_policies.size() > 1) {
+    test_pages<T>(sizes, cost);
+  } else {
+    // with the summary only, the sweep itself is not printed
+    test<T>(sweep(sizes), cost, summary_only);
+  }
+}
+
+#define INSTANTIATE(T) template void test_sweep<T>(const std::vector<long long>& sizes, float64_t cost);
+FOR_EACH_TYPE(INSTANTIATE)
@@ -0,0 +1,119 @@
+#include <chrono>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "cli.h"
+#include "loaded.h"
+#include "measure.h"
+#include "modes.h"
+#include "omp-helper.h"
+#include "placement.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+static bool traffic_stop = false;
+
+extern "C" void stop_traffic(int) {
+  __atomic_store_n(&traffic_stop, true, __ATOMIC_RELAXED);
+}
+
+// generates "traffic_rate" bytes per second with a fraction "traffic_writes" of writes on buffers of
+// "size" bytes (over all the threads) until signalled, and reports the bandwidth achieved every second
+void run_traffic(long long size) {
+#ifdef _OPENMP
+  const int k = thread_counts.empty() ? max_threads : thread_counts.front();
+#else
+  const int k = 1;
+#endif
+  set_num_threads(k);
+  std::vector<int> cpus = pin_threads(k);
+  const long long m = round_down(size / k, 0x1000);
+  // the fastest variants of the reads and of the writes (with non-temporal stores only with -w nontemporal)
+  variant_filter temporal = filter;
+  temporal.temporal = true;
+  temporal.nontemporal = false;
+  const bandwidth* reader = fastest_variant(bandwidth_op::read, m * k, k, temporal);
+  const bandwidth* writer = fastest_variant(bandwidth_op::write, m * k, k, filter.temporal ? temporal : filter);
+  std::signal(SIGINT, stop_traffic);
+  std::signal(SIGTERM, stop_traffic);
+
+  std::cout << std::setprecision(3);
+  std::ostringstream title;
+  title << std::setprecision(3) << "Generating traffic: " << (traffic_rate > 0. ? bytes(traffic_rate) : bytes(0.)) << (traffic_rate > 0. ? "/s" : " (unlimited)");
+  title << "  writes: " << 100. * traffic_writes << "%  threads: " << k << "  size: " << bytes(m * k);
+  if (!cpus.empty()) title << "  cpus: " << format_list(cpus);
+  print_header("time,read,write,total", title.str());
+
+  unsigned long long read = 0, written = 0;
+  bool failed = false;
+  auto generate = [&]() {
+    void *buffer = allocate(m, 0x1000);
+    if (!buffer) {
+      __atomic_store_n(&failed, true, __ATOMIC_RELAXED);
+      __atomic_store_n(&traffic_stop, true, __ATOMIC_RELAXED);
+    } else {
+      for (long long i = 0; i < m; ++i) static_cast<char*>(buffer)[i] = 0;
+      generate_traffic(reader, writer, buffer, m, traffic_rate / k, traffic_writes, &traffic_stop, &read, &written);
+      deallocate(buffer);
+    }
+  };
+  auto report = [&]() {
+    auto start = std::chrono::steady_clock::now(), last = start;
+    unsigned long long last_read = 0, last_written = 0;
+    int seconds = 0;
+    while (!__atomic_load_n(&traffic_stop, __ATOMIC_RELAXED)) {
+      // short sleeps: a signal stops the report without waiting for the end of the second
+      auto next = start + std::chrono::seconds(seconds + 1);
+      while (std::chrono::steady_clock::now() < next && !__atomic_load_n(&traffic_stop, __ATOMIC_RELAXED)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      if (__atomic_load_n(&traffic_stop, __ATOMIC_RELAXED)) break;
+      auto now = std::chrono::steady_clock::now();
+      unsigned long long r = __atomic_load_n(&read, __ATOMIC_RELAXED), w = __atomic_load_n(&written, __ATOMIC_RELAXED);
+      float64_t dt = std::chrono::duration<float64_t>(now - last).count();
+      ++seconds;
+      if (CSV) {
+        std::cout << seconds << ',' << (r - last_read) / dt << ',' << (w - last_written) / dt << ',' << (r + w - last_read - last_written) / dt;
+        print_config_row(k, 0);
+      } else {
+        std::cout << "  time: " << std::setw(6) << seconds << " s";
+        std::cout << "  \tread: " << std::setw(6) << bytes((r - last_read) / dt) << "/s";
+        std::cout << "  \twrite: " << std::setw(6) << bytes((w - last_written) / dt) << "/s";
+        std::cout << "  \ttotal: " << std::setw(6) << bytes((r + w - last_read - last_written) / dt) << "/s";
+      }
+      std::cout << std::endl;
+      last = now;
+      last_read = r;
+      last_written = w;
+      if (traffic_duration > 0. && seconds >= traffic_duration) {
+        __atomic_store_n(&traffic_stop, true, __ATOMIC_RELAXED);
+      }
+    }
+    if (!CSV && seconds > 0) {
+      float64_t dt = std::chrono::duration<float64_t>(last - start).count();
+      std::cout << "  average: \tread: " << std::setw(6) << bytes(last_read / dt) << "/s  \twrite: " << std::setw(6) << bytes(last_written / dt) << "/s";
+      std::cout << "  \ttotal: " << std::setw(6) << bytes((last_read + last_written) / dt) << "/s" << std::endl;
+    }
+  };
+#ifdef _OPENMP
+  // threads 0 to k-1 generate the traffic, thread k reports it
+  OMP(parallel num_threads(k + 1)) {
+    if (omp_get_thread_num() < k) {
+      generate();
+    } else {
+      report();
+    }
+  }
+#else
+  // the main thread generates the traffic, another one reports it
+  std::thread reporter(report);
+  generate();
+  reporter.join();
+#endif
+  if (failed) allocation_failed();
+}
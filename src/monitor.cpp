@@ -0,0 +1,83 @@
+#include <unistd.h>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <cstdlib>
+#include "monitor.h"
+
+std::string host_name() {
+  char name[256] = {};
+  if (gethostname(name, sizeof(name) - 1) != 0 || name[0] == '\0') return "localhost";
+  return name;
+}
+
+std::string utc_time() {
+  std::time_t t = std::time(nullptr);
+  std::tm tm;
+  char buffer[32] = {};
+  if (!gmtime_r(&t, &tm) || std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm) == 0) return "";
+  return buffer;
+}
+
+// file format: "key,bandwidth,runs" per line
+bool load_baseline(const std::string& path, baseline& base) {
+  base.clear();
+  std::ifstream file(path);
+  if (!file) return true;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::string::size_type b = line.rfind(','), a = b == std::string::npos ? b : line.rfind(',', b - 1);
+    if (a == std::string::npos || a == 0) return false;
+    baseline_entry e;
+    e.bandwidth = std::strtod(line.c_str() + a + 1, nullptr);
+    e.runs = std::atoi(line.c_str() + b + 1);
+    if (!(e.bandwidth >= 0.) || e.runs < 0) return false;
+    base[line.substr(0, a)] = e;
+  }
+  return true;
+}
+
+bool save_baseline(const std::string& path, const baseline& base) {
+  // written next to the file, then renamed: an interrupted run keeps the previous baseline
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream file(tmp);
+    if (!file) return false;
+    file.precision(17);
+    file << "# probe:op,bandwidth (bytes per second),runs\n";
+    for (const auto& entry : base) {
+      file << entry.first << ',' << entry.second.bandwidth << ',' << entry.second.runs << '\n';
+    }
+    if (!file.flush()) return false;
+  }
+  return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool append_history(const std::string& path, const std::string& header, const std::vector<std::string>& rows, long long limit) {
+  std::deque<std::string> kept;
+  {
+    std::ifstream file(path);
+    std::string line;
+    // skips the header
+    if (file) std::getline(file, line);
+    while (std::getline(file, line)) {
+      kept.push_back(line);
+      if ((long long) kept.size() > limit) kept.pop_front();
+    }
+  }
+  for (const std::string& row : rows) {
+    kept.push_back(row);
+    if ((long long) kept.size() > limit) kept.pop_front();
+  }
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream file(tmp);
+    if (!file) return false;
+    file << header << '\n';
+    for (const std::string& row : kept) file << row << '\n';
+    if (!file.flush()) return false;
+  }
+  return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
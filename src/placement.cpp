@@ -0,0 +1,254 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "placement.h"
+
+std::vector<int> parse_list(const char* s) {
+  std::vector<int> list;
+  if (!s) return list;
+  std::string str(s);
+  if (str == "all") return list;
+  const char* p = str.c_str();
+  while (*p) {
+    char* end = nullptr;
+    long first = std::strtol(p, &end, 10);
+    if (end == p) break;
+    long last = first;
+    p = end;
+    if (*p == '-') {
+      ++p;
+      last = std::strtol(p, &end, 10);
+      if (end == p) last = first;
+      p = end;
+    }
+    for (long i = first; i <= last; ++i) {
+      list.push_back(i);
+    }
+    while (*p && *p != ',') ++p;
+    if (*p) ++p;
+  }
+  return list;
+}
+
+std::string format_list(const std::vector<int>& list) {
+  std::string s;
+  for (unsigned i = 0; i < list.size(); ) {
+    unsigned j = i;
+    while (j+1 < list.size() && list[j+1] == list[j] + 1) ++j;
+    if (!s.empty()) s += ',';
+    s += std::to_string(list[i]);
+    if (j > i) s += '-' + std::to_string(list[j]);
+    i = j+1;
+  }
+  return s;
+}
+
+static std::vector<int> read_list(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  if (!file || !std::getline(file, line)) return {};
+  return parse_list(line.c_str());
+}
+static int read_int(const std::string& path, int fallback) {
+  std::ifstream file(path);
+  int value;
+  if (!file || !(file >> value)) return fallback;
+  return value;
+}
+
+std::vector<int> numa_nodes() {
+  std::vector<int> nodes = read_list("/sys/devices/system/node/online");
+  if (nodes.empty()) nodes.push_back(0);
+  return nodes;
+}
+std::vector<int> numa_cpu_nodes() {
+  std::vector<int> nodes = read_list("/sys/devices/system/node/has_cpu");
+  if (nodes.empty()) nodes.push_back(0);
+  return nodes;
+}
+std::vector<int> numa_node_cpus(int node) {
+  return read_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+}
+
+bool bind_thread(const std::vector<int>& cpus) {
+  if (cpus.empty()) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+bool bind_thread_to_nodes(const std::vector<int>& nodes) {
+  std::vector<int> cpus;
+  for (int node : nodes) {
+    std::vector<int> node_cpus = numa_node_cpus(node);
+    cpus.insert(cpus.end(), node_cpus.begin(), node_cpus.end());
+  }
+  return bind_thread(cpus);
+}
+
+std::vector<int> process_cpus() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+  }
+  if (cpus.empty()) cpus = read_list("/sys/devices/system/cpu/online");
+  return cpus;
+}
+
+const char* affinity_name(affinity p) {
+  switch (p) {
+    case affinity::none:    return "none";
+    case affinity::compact: return "compact";
+    case affinity::scatter: return "scatter";
+    case affinity::cores:   return "cores";
+    case affinity::smt:     return "smt";
+  }
+  return "";
+}
+
+bool parse_affinity(const char* s, affinity& p) {
+  for (affinity q : {affinity::none, affinity::compact, affinity::scatter, affinity::cores, affinity::smt}) {
+    if (std::strcmp(s, affinity_name(q)) == 0) {
+      p = q;
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+  // position of a CPU in the topology (read from /sys/devices/system/cpu)
+  struct cpu_topology {
+    int cpu;
+    int package; // socket
+    int l3;      // first CPU sharing the L3
+    int core;    // first CPU of the physical core
+    int smt;     // rank among the SMT siblings of the core
+    int rank;    // rank of the L3 domain within its package
+  };
+
+  std::vector<cpu_topology> read_topology(const std::vector<int>& cpus) {
+    std::vector<cpu_topology> topo;
+    for (int cpu : cpus) {
+      std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+      cpu_topology t = {cpu, read_int(dir + "/topology/physical_package_id", 0), -1, cpu, 0, 0};
+      std::vector<int> siblings = read_list(dir + "/topology/thread_siblings_list");
+      if (!siblings.empty()) {
+        t.core = siblings.front();
+        t.smt = std::find(siblings.begin(), siblings.end(), cpu) - siblings.begin();
+      }
+      for (int index = 0; index < 16; ++index) {
+        std::string cache = dir + "/cache/index" + std::to_string(index);
+        int level = read_int(cache + "/level", -1);
+        if (level < 0) break;
+        if (level != 3) continue;
+        std::vector<int> shared = read_list(cache + "/shared_cpu_list");
+        if (!shared.empty()) t.l3 = shared.front();
+      }
+      // no L3: the socket is the L3 domain
+      if (t.l3 < 0) t.l3 = -1 - t.package;
+      topo.push_back(t);
+    }
+    // rank of the L3 domains within their package
+    std::vector<std::pair<int, int>> domains;
+    for (const cpu_topology& t : topo) domains.push_back({t.package, t.l3});
+    std::sort(domains.begin(), domains.end());
+    domains.erase(std::unique(domains.begin(), domains.end()), domains.end());
+    for (cpu_topology& t : topo) {
+      for (const auto& d : domains) {
+        if (d.first == t.package && d.second < t.l3) ++t.rank;
+      }
+    }
+    return topo;
+  }
+}
+
+std::vector<cache_level> cache_levels() {
+  std::vector<cache_level> levels;
+  std::vector<int> cpus = read_list("/sys/devices/system/cpu/online");
+  if (cpus.empty()) cpus.push_back(0);
+  for (int index = 0; index < 16; ++index) {
+    std::string cache = "/sys/devices/system/cpu/cpu" + std::to_string(cpus.front()) + "/cache/index" + std::to_string(index);
+    int level = read_int(cache + "/level", -1);
+    if (level < 0) break;
+    std::string type;
+    std::ifstream(cache + "/type") >> type;
+    if (type == "Instruction") continue;
+
+    // eg: "48K", "2048K" or "32M"
+    std::string size;
+    std::ifstream(cache + "/size") >> size;
+    char* unit = nullptr;
+    long long bytes = std::strtoll(size.c_str(), &unit, 10);
+    if (unit && *unit == 'K') bytes <<= 10;
+    if (unit && *unit == 'M') bytes <<= 20;
+    if (unit && *unit == 'G') bytes <<= 30;
+    if (bytes <= 0) continue;
+
+    // instances: distinct sets of CPUs sharing the cache
+    std::vector<int> firsts;
+    for (int cpu : cpus) {
+      std::vector<int> shared = read_list("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index" + std::to_string(index) + "/shared_cpu_list");
+      firsts.push_back(shared.empty() ? cpu : shared.front());
+    }
+    std::sort(firsts.begin(), firsts.end());
+    int instances = std::unique(firsts.begin(), firsts.end()) - firsts.begin();
+    levels.push_back({level, bytes, instances});
+  }
+  std::sort(levels.begin(), levels.end(), [](const cache_level& a, const cache_level& b){ return a.level < b.level; });
+  return levels;
+}
+
+std::vector<int> affinity_cpus(affinity policy, int threads, const std::vector<int>& allowed) {
+  std::vector<cpu_topology> topo = read_topology(allowed);
+  std::vector<int> cpus;
+  if (topo.empty() || threads < 1) return cpus;
+
+  auto key = [policy](const cpu_topology& t) {
+    switch (policy) {
+      case affinity::scatter: return std::make_tuple(t.smt, t.core, t.rank, t.package);
+      case affinity::smt:     return std::make_tuple(t.package, t.l3, t.core, t.smt);
+      default:                return std::make_tuple(t.package, t.smt, t.l3, t.core);
+    }
+  };
+  if (policy == affinity::cores) {
+    topo.erase(std::remove_if(topo.begin(), topo.end(), [](const cpu_topology& t){ return t.smt != 0; }), topo.end());
+  }
+  std::stable_sort(topo.begin(), topo.end(), [&key](const cpu_topology& a, const cpu_topology& b){ return key(a) < key(b); });
+  if (policy == affinity::scatter) {
+    // round-robin over the (package, L3) domains: k-th core of every domain before the (k+1)-th
+    std::vector<std::pair<int, int>> domains;
+    for (const cpu_topology& t : topo) domains.push_back({t.rank, t.package});
+    std::sort(domains.begin(), domains.end());
+    domains.erase(std::unique(domains.begin(), domains.end()), domains.end());
+    std::vector<std::vector<int>> queues(domains.size());
+    for (const cpu_topology& t : topo) {
+      unsigned d = std::lower_bound(domains.begin(), domains.end(), std::make_pair(t.rank, t.package)) - domains.begin();
+      queues[d].push_back(t.cpu);
+    }
+    std::vector<int> order;
+    for (unsigned k = 0; order.size() < topo.size(); ++k) {
+      for (const std::vector<int>& q : queues) {
+        if (k < q.size()) order.push_back(q[k]);
+      }
+    }
+    for (int i = 0; i < threads; ++i) cpus.push_back(order[i % order.size()]);
+    return cpus;
+  }
+  for (int i = 0; i < threads; ++i) cpus.push_back(topo[i % topo.size()].cpu);
+  return cpus;
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "stats.h"
+
+static std::vector<float64_t> recorded;
+static long long total = 0;
+// end of the budget of the current measurement, and of the one shared by the "pending" next ones
+static std::chrono::steady_clock::time_point deadline, shared_end;
+static int pending = 0;
+
+convergence adaptive;
+
+static std::chrono::steady_clock::duration budget() {
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float64_t>(adaptive.budget));
+}
+
+void samples_budget_split(int measures) noexcept {
+  shared_end = std::chrono::steady_clock::now() + budget();
+  pending = measures;
+}
+void samples_reset() noexcept {
+  recorded.clear();
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if (pending > 0) {
+    deadline = now + std::max(shared_end - now, std::chrono::steady_clock::duration::zero()) / pending;
+    --pending;
+  } else {
+    deadline = now + budget();
+  }
+}
+void samples_record(float64_t seconds) noexcept {
+  ++total;
+  try {
+    recorded.push_back(seconds);
+  } catch (...) {
+  }
+}
+const std::vector<float64_t>& samples() {
+  return recorded;
+}
+long long samples_total() noexcept {
+  return total;
+}
+
+bool samples_converged() noexcept {
+  int n = recorded.size();
+  if (n < adaptive.min_tries) return false;
+  if (n >= adaptive.max_tries) return true;
+  if (std::chrono::steady_clock::now() >= deadline) return true;
+
+  // distribution-free confidence interval of the median: order statistics n/2 -+ 1.96 sqrt(n)/2
+  std::vector<float64_t> s;
+  try {
+    s = recorded;
+  } catch (...) {
+    return true;
+  }
+  std::sort(s.begin(), s.end());
+  float64_t half = 0.98 * std::sqrt(static_cast<float64_t>(n));
+  int lo = std::max(0, static_cast<int>(std::floor(0.5 * n - half)));
+  int hi = std::min(n-1, static_cast<int>(std::ceil(0.5 * n + half)));
+  float64_t median = (n % 2) ? s[n/2] : 0.5 * (s[n/2 - 1] + s[n/2]);
+  if (median <= 0.) return true;
+  return 0.5 * (s[hi] - s[lo]) / median < adaptive.target;
+}
+
+stats compute_stats(std::vector<float64_t> s) {
+  stats r;
+  r.count = s.size();
+  if (s.empty()) return r;
+  std::sort(s.begin(), s.end());
+  r.min = s.front();
+  r.median = (s.size() % 2) ? s[s.size()/2] : 0.5 * (s[s.size()/2 - 1] + s[s.size()/2]);
+  // nearest-rank percentile
+  r.p95 = s[static_cast<unsigned>(std::ceil(0.95 * s.size())) - 1];
+  float64_t sum = 0.;
+  for (float64_t x : s) sum += x;
+  r.mean = sum / s.size();
+  float64_t var = 0.;
+  for (float64_t x : s) var += (x - r.mean) * (x - r.mean);
+  r.stddev = s.size() > 1 ? std::sqrt(var / (s.size() - 1)) : 0.;
+  r.cv = r.mean > 0. ? r.stddev / r.mean : 0.;
+  return r;
+}
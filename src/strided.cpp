@@ -0,0 +1,58 @@
+#include "strided.h"
+#include "bench.h"
+#include "stream.h"
+
+namespace {
+  template <class T>
+  float64_t read(const void* A, long long stride, long long n, int repeat, int tries) noexcept {
+    const T* a = static_cast<const T*>(A);
+    long long s = stride / sizeof(T);
+    return sizeof(T) * n / bench([a, n, s]{ strided::read(a, n, s); }, repeat, tries);
+  }
+  template <class T>
+  float64_t write(void* A, long long stride, long long n, int repeat, int tries) noexcept {
+    T* a = static_cast<T*>(A);
+    long long s = stride / sizeof(T);
+    return sizeof(T) * n / bench([a, n, s]{ strided::write(a, n, s); }, repeat, tries);
+  }
+  template <class T>
+  float64_t copy(const void* A, void* B, long long stride, long long n, int repeat, int tries) noexcept {
+    const T* a = static_cast<const T*>(A);
+    T* b = static_cast<T*>(B);
+    long long s = stride / sizeof(T);
+    return 2*sizeof(T) * n / bench([a, b, n, s]{ strided::copy(a, b, n, s); }, repeat, tries);
+  }
+}
+
+float64_t strided_read(const void* A, int elem_size, long long stride, long long n, int repeat, int tries) noexcept {
+  if (n == 0 || stride % elem_size != 0) return 0.;
+  switch (elem_size) {
+    case 1: return read<int8_t>(A, stride, n, repeat, tries);
+    case 2: return read<int16_t>(A, stride, n, repeat, tries);
+    case 4: return read<int32_t>(A, stride, n, repeat, tries);
+    case 8: return read<int64_t>(A, stride, n, repeat, tries);
+  }
+  return 0.;
+}
+
+float64_t strided_write(void* A, int elem_size, long long stride, long long n, int repeat, int tries) noexcept {
+  if (n == 0 || stride % elem_size != 0) return 0.;
+  switch (elem_size) {
+    case 1: return write<int8_t>(A, stride, n, repeat, tries);
+    case 2: return write<int16_t>(A, stride, n, repeat, tries);
+    case 4: return write<int32_t>(A, stride, n, repeat, tries);
+    case 8: return write<int64_t>(A, stride, n, repeat, tries);
+  }
+  return 0.;
+}
+
+float64_t strided_copy(const void* A, void* B, int elem_size, long long stride, long long n, int repeat, int tries) noexcept {
+  if (n == 0 || stride % elem_size != 0) return 0.;
+  switch (elem_size) {
+    case 1: return copy<int8_t>(A, B, stride, n, repeat, tries);
+    case 2: return copy<int16_t>(A, B, stride, n, repeat, tries);
+    case 4: return copy<int32_t>(A, B, stride, n, repeat, tries);
+    case 8: return copy<int64_t>(A, B, stride, n, repeat, tries);
+  }
+  return 0.;
+}
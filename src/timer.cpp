@@ -15,30 +15,62 @@ static inline Timer::counter_t read_time(void) noexcept {
 
 
 #ifdef __x86_64__
+#include <algorithm>
+#include <cpuid.h>
 #include <unistd.h>
 #include <x86intrin.h>
 
-static inline float64_t get_nominal_frequency() {
-  Timer::counter_t t0, t1, c0, c1;
-  float64_t dt, dc;
-
-  t0 = read_time();
-  c0 = _rdtsc();
-
-  usleep(100000); // wait for 0.1 sec
-
-  t1 = read_time();
-  c1 = _rdtsc();
+static bool has_cpuid_bit(unsigned int leaf, int bit) noexcept {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(leaf, &eax, &ebx, &ecx, &edx)) return false;
+  return (edx >> bit) & 1;
+}
 
-  dt = (Timer::diff_t) t1 - (Timer::diff_t) t0;
-  dt *= 1e-9;
-  dc = (Timer::diff_t) c1 - (Timer::diff_t) c0;
+// rdtscp: cpuid 0x80000001 edx bit 27, invariant TSC: cpuid 0x80000007 edx bit 8
+static const bool has_rdtscp = has_cpuid_bit(0x80000001, 27);
+bool Timer::invariant = has_cpuid_bit(0x80000007, 8);
 
-  return dc / dt;
+// TSC ticks per second: median of several windows, each bracketed by two reads of the clock
+static inline float64_t get_nominal_frequency() {
+  const int samples = 7;
+  float64_t f[samples];
+  for (int i = 0; i < samples; ++i) {
+    Timer::counter_t t0 = read_time();
+    Timer::counter_t c0 = _rdtsc();
+    Timer::counter_t t0e = read_time();
+
+    usleep(20000); // wait for 20 ms
+
+    Timer::counter_t t1 = read_time();
+    Timer::counter_t c1 = _rdtsc();
+    Timer::counter_t t1e = read_time();
+
+    // the TSC is read in the middle of each bracket
+    float64_t dt = 0.5 * ((Timer::diff_t) (t1 + t1e) - (Timer::diff_t) (t0 + t0e));
+    dt *= 1e-9;
+    float64_t dc = (Timer::diff_t) c1 - (Timer::diff_t) c0;
+    f[i] = dc / dt;
+  }
+  std::sort(f, f + samples);
+  return f[samples / 2];
 }
 
+// the loads and stores before the start of a timed region complete before it is read, and the region
+// does not start before it is read
 __attribute((noinline)) Timer::counter_t Timer::read(void) noexcept {
-  return _rdtsc();
+  _mm_lfence();
+  Timer::counter_t t = _rdtsc();
+  _mm_lfence();
+  return t;
+}
+
+// the region completes before the end is read (rdtscp waits for the previous instructions)
+__attribute((noinline)) Timer::counter_t Timer::read_end(void) noexcept {
+  if (!has_rdtscp) return read();
+  unsigned int aux;
+  Timer::counter_t t = __rdtscp(&aux);
+  _mm_lfence();
+  return t;
 }
 
 float64_t Timer::frequency = get_nominal_frequency();
@@ -48,9 +80,13 @@ bool Timer::low_overhead = true;
 __attribute((noinline)) Timer::counter_t Timer::read(void) noexcept {
   return read_time();
 }
+__attribute((noinline)) Timer::counter_t Timer::read_end(void) noexcept {
+  return read_time();
+}
 
 float64_t Timer::frequency = 1e9;
 bool Timer::low_overhead = false;
+bool Timer::invariant = true;
 
 #endif
 
@@ -61,7 +97,7 @@ static inline Timer::diff_t compute_overhead(int tries) noexcept {
   for (i = 0; i < tries; ++i) {
     Timer::reset();
     t0 = Timer::read();
-    t1 = Timer::read();
+    t1 = Timer::read_end();
     d = (Timer::diff_t) t1 - (Timer::diff_t) t0;
     dmin = (d > 0 && (dmin < 0 || d < dmin)) ? d : dmin;
   }